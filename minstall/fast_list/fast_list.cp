@@ -7,12 +7,452 @@ PUBLIC(
         METHOD(get)
         METHOD(size)
         METHOD(clear)
+        METHOD(sum)
+        METHOD(minimum)
+        METHOD(maximum)
+        METHOD(sorted)
+        METHOD(reversed)
+        METHOD(stats)
+        METHOD(sort)
+        METHOD(reverse)
+        METHOD(to_list)
+        METHOD(view)
+        METHOD(view_count)
+        METHOD(capacity)
+        METHOD(itemsize)
+        METHOD(extend)
+        METHOD(extend_list)
+        METHOD(extend_buffer)
+        METHOD(extend_range)
+        METHOD(reserve)
+        METHOD(resize)
+        METHOD(set_growth_factor)
+        METHOD(get_growth_factor)
+        METHOD(gather)
+        METHOD(gather_list)
+        METHOD(scatter)
+        METHOD(scatter_list)
+        METHOD(set)
+        METHOD(set_bounds_policy)
+        METHOD(get_bounds_policy)
+        METHOD(set_fill_value)
+        METHOD(get_fill_value)
+        METHOD(set_track_aggregates)
+        METHOD(get_track_aggregates)
+        METHOD(invalidate_aggregates)
+        METHOD(range_sum)
+        METHOD(set_range_sum_index)
+        METHOD(get_range_sum_index)
+        METHOD(range_min)
+        METHOD(range_max)
+        METHOD(range_argmin)
+        METHOD(range_argmax)
+        METHOD(set_range_extreme_index)
+        METHOD(get_range_extreme_index)
+        METHOD(sliding_min)
+        METHOD(sliding_max)
+        METHOD(topk)
+        METHOD(partial_sorted)
+        METHOD(nth)
+        METHOD(quantiles)
+        METHOD(argsort)
+        METHOD(sort_by_key, FastList&)
+        METHOD(sort_by_key, FastListI64&)
+        METHOD(sort_by_key, FastListF32&)
+        METHOD(sort_by_key, FastListF64&)
+        METHOD(sort_by_key, FastListU8&)
         FIELD(data)
     }
 
-    fast_list FUNC(fast_sort)
-    fast_list FUNC(fast_reverse)
-    fast_list FUNC(fast_sum)
-    fast_list FUNC(fast_max)
-    fast_list FUNC(fast_min)
+    fast_list CLASS(FastListI64) {
+        METHOD(add)
+        METHOD(get)
+        METHOD(size)
+        METHOD(clear)
+        METHOD(sum)
+        METHOD(minimum)
+        METHOD(maximum)
+        METHOD(sorted)
+        METHOD(reversed)
+        METHOD(stats)
+        METHOD(sort)
+        METHOD(reverse)
+        METHOD(to_list)
+        METHOD(view)
+        METHOD(view_count)
+        METHOD(capacity)
+        METHOD(itemsize)
+        METHOD(extend)
+        METHOD(extend_list)
+        METHOD(extend_buffer)
+        METHOD(extend_range)
+        METHOD(reserve)
+        METHOD(resize)
+        METHOD(set_growth_factor)
+        METHOD(get_growth_factor)
+        METHOD(gather)
+        METHOD(gather_list)
+        METHOD(scatter)
+        METHOD(scatter_list)
+        METHOD(set)
+        METHOD(set_bounds_policy)
+        METHOD(get_bounds_policy)
+        METHOD(set_fill_value)
+        METHOD(get_fill_value)
+        METHOD(set_track_aggregates)
+        METHOD(get_track_aggregates)
+        METHOD(invalidate_aggregates)
+        METHOD(range_sum)
+        METHOD(set_range_sum_index)
+        METHOD(get_range_sum_index)
+        METHOD(range_min)
+        METHOD(range_max)
+        METHOD(range_argmin)
+        METHOD(range_argmax)
+        METHOD(set_range_extreme_index)
+        METHOD(get_range_extreme_index)
+        METHOD(sliding_min)
+        METHOD(sliding_max)
+        METHOD(topk)
+        METHOD(partial_sorted)
+        METHOD(nth)
+        METHOD(quantiles)
+        METHOD(argsort)
+        METHOD(sort_by_key, FastList&)
+        METHOD(sort_by_key, FastListI64&)
+        METHOD(sort_by_key, FastListF32&)
+        METHOD(sort_by_key, FastListF64&)
+        METHOD(sort_by_key, FastListU8&)
+        FIELD(data)
+    }
+
+    fast_list CLASS(FastListF32) {
+        METHOD(add)
+        METHOD(get)
+        METHOD(size)
+        METHOD(clear)
+        METHOD(sum)
+        METHOD(minimum)
+        METHOD(maximum)
+        METHOD(sorted)
+        METHOD(reversed)
+        METHOD(stats)
+        METHOD(sort)
+        METHOD(reverse)
+        METHOD(to_list)
+        METHOD(view)
+        METHOD(view_count)
+        METHOD(capacity)
+        METHOD(itemsize)
+        METHOD(extend)
+        METHOD(extend_list)
+        METHOD(extend_buffer)
+        METHOD(extend_range)
+        METHOD(reserve)
+        METHOD(resize)
+        METHOD(set_growth_factor)
+        METHOD(get_growth_factor)
+        METHOD(gather)
+        METHOD(gather_list)
+        METHOD(scatter)
+        METHOD(scatter_list)
+        METHOD(set)
+        METHOD(set_bounds_policy)
+        METHOD(get_bounds_policy)
+        METHOD(set_fill_value)
+        METHOD(get_fill_value)
+        METHOD(set_track_aggregates)
+        METHOD(get_track_aggregates)
+        METHOD(invalidate_aggregates)
+        METHOD(range_sum)
+        METHOD(set_range_sum_index)
+        METHOD(get_range_sum_index)
+        METHOD(range_min)
+        METHOD(range_max)
+        METHOD(range_argmin)
+        METHOD(range_argmax)
+        METHOD(set_range_extreme_index)
+        METHOD(get_range_extreme_index)
+        METHOD(sliding_min)
+        METHOD(sliding_max)
+        METHOD(topk)
+        METHOD(partial_sorted)
+        METHOD(nth)
+        METHOD(quantiles)
+        METHOD(argsort)
+        METHOD(sort_by_key, FastList&)
+        METHOD(sort_by_key, FastListI64&)
+        METHOD(sort_by_key, FastListF32&)
+        METHOD(sort_by_key, FastListF64&)
+        METHOD(sort_by_key, FastListU8&)
+        FIELD(data)
+    }
+
+    fast_list CLASS(FastListF64) {
+        METHOD(add)
+        METHOD(get)
+        METHOD(size)
+        METHOD(clear)
+        METHOD(sum)
+        METHOD(minimum)
+        METHOD(maximum)
+        METHOD(sorted)
+        METHOD(reversed)
+        METHOD(stats)
+        METHOD(sort)
+        METHOD(reverse)
+        METHOD(to_list)
+        METHOD(view)
+        METHOD(view_count)
+        METHOD(capacity)
+        METHOD(itemsize)
+        METHOD(extend)
+        METHOD(extend_list)
+        METHOD(extend_buffer)
+        METHOD(extend_range)
+        METHOD(reserve)
+        METHOD(resize)
+        METHOD(set_growth_factor)
+        METHOD(get_growth_factor)
+        METHOD(gather)
+        METHOD(gather_list)
+        METHOD(scatter)
+        METHOD(scatter_list)
+        METHOD(set)
+        METHOD(set_bounds_policy)
+        METHOD(get_bounds_policy)
+        METHOD(set_fill_value)
+        METHOD(get_fill_value)
+        METHOD(set_track_aggregates)
+        METHOD(get_track_aggregates)
+        METHOD(invalidate_aggregates)
+        METHOD(range_sum)
+        METHOD(set_range_sum_index)
+        METHOD(get_range_sum_index)
+        METHOD(range_min)
+        METHOD(range_max)
+        METHOD(range_argmin)
+        METHOD(range_argmax)
+        METHOD(set_range_extreme_index)
+        METHOD(get_range_extreme_index)
+        METHOD(sliding_min)
+        METHOD(sliding_max)
+        METHOD(topk)
+        METHOD(partial_sorted)
+        METHOD(nth)
+        METHOD(quantiles)
+        METHOD(argsort)
+        METHOD(sort_by_key, FastList&)
+        METHOD(sort_by_key, FastListI64&)
+        METHOD(sort_by_key, FastListF32&)
+        METHOD(sort_by_key, FastListF64&)
+        METHOD(sort_by_key, FastListU8&)
+        FIELD(data)
+    }
+
+    fast_list CLASS(FastListU8) {
+        METHOD(add)
+        METHOD(get)
+        METHOD(size)
+        METHOD(clear)
+        METHOD(sum)
+        METHOD(minimum)
+        METHOD(maximum)
+        METHOD(sorted)
+        METHOD(reversed)
+        METHOD(stats)
+        METHOD(sort)
+        METHOD(reverse)
+        METHOD(to_list)
+        METHOD(view)
+        METHOD(view_count)
+        METHOD(capacity)
+        METHOD(itemsize)
+        METHOD(extend)
+        METHOD(extend_list)
+        METHOD(extend_buffer)
+        METHOD(extend_range)
+        METHOD(reserve)
+        METHOD(resize)
+        METHOD(set_growth_factor)
+        METHOD(get_growth_factor)
+        METHOD(gather)
+        METHOD(gather_list)
+        METHOD(scatter)
+        METHOD(scatter_list)
+        METHOD(set)
+        METHOD(set_bounds_policy)
+        METHOD(get_bounds_policy)
+        METHOD(set_fill_value)
+        METHOD(get_fill_value)
+        METHOD(set_track_aggregates)
+        METHOD(get_track_aggregates)
+        METHOD(invalidate_aggregates)
+        METHOD(range_sum)
+        METHOD(set_range_sum_index)
+        METHOD(get_range_sum_index)
+        METHOD(range_min)
+        METHOD(range_max)
+        METHOD(range_argmin)
+        METHOD(range_argmax)
+        METHOD(set_range_extreme_index)
+        METHOD(get_range_extreme_index)
+        METHOD(sliding_min)
+        METHOD(sliding_max)
+        METHOD(topk)
+        METHOD(partial_sorted)
+        METHOD(nth)
+        METHOD(quantiles)
+        METHOD(argsort)
+        METHOD(sort_by_key, FastList&)
+        METHOD(sort_by_key, FastListI64&)
+        METHOD(sort_by_key, FastListF32&)
+        METHOD(sort_by_key, FastListF64&)
+        METHOD(sort_by_key, FastListU8&)
+        FIELD(data)
+    }
+
+    fast_list CLASS(FastStats) {
+        CONSTRUCTOR()
+        FIELD(count)
+        FIELD(sum)
+        FIELD(min)
+        FIELD(max)
+        FIELD(argmin)
+        FIELD(argmax)
+        FIELD(mean)
+        FIELD(variance)
+    }
+
+    fast_list CLASS(FastStatsI64) {
+        CONSTRUCTOR()
+        FIELD(count)
+        FIELD(sum)
+        FIELD(min)
+        FIELD(max)
+        FIELD(argmin)
+        FIELD(argmax)
+        FIELD(mean)
+        FIELD(variance)
+    }
+
+    fast_list CLASS(FastStatsF32) {
+        CONSTRUCTOR()
+        FIELD(count)
+        FIELD(sum)
+        FIELD(min)
+        FIELD(max)
+        FIELD(argmin)
+        FIELD(argmax)
+        FIELD(mean)
+        FIELD(variance)
+    }
+
+    fast_list CLASS(FastStatsF64) {
+        CONSTRUCTOR()
+        FIELD(count)
+        FIELD(sum)
+        FIELD(min)
+        FIELD(max)
+        FIELD(argmin)
+        FIELD(argmax)
+        FIELD(mean)
+        FIELD(variance)
+    }
+
+    fast_list CLASS(FastStatsU8) {
+        CONSTRUCTOR()
+        FIELD(count)
+        FIELD(sum)
+        FIELD(min)
+        FIELD(max)
+        FIELD(argmin)
+        FIELD(argmax)
+        FIELD(mean)
+        FIELD(variance)
+    }
+
+    fast_list FUNC(fast_sort, const std::vector<int>&)
+    fast_list FUNC(fast_sort, const std::vector<int64_t>&)
+    fast_list FUNC(fast_sort, const std::vector<double>&)
+    fast_list FUNC(fast_sort, const std::vector<float>&)
+    fast_list FUNC(fast_sort, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_reverse, const std::vector<int>&)
+    fast_list FUNC(fast_reverse, const std::vector<int64_t>&)
+    fast_list FUNC(fast_reverse, const std::vector<double>&)
+    fast_list FUNC(fast_reverse, const std::vector<float>&)
+    fast_list FUNC(fast_reverse, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_sort_into, const FastList&, FastList&)
+    fast_list FUNC(fast_sort_into, const FastListI64&, FastListI64&)
+    fast_list FUNC(fast_sort_into, const FastListF32&, FastListF32&)
+    fast_list FUNC(fast_sort_into, const FastListF64&, FastListF64&)
+    fast_list FUNC(fast_sort_into, const FastListU8&, FastListU8&)
+    fast_list FUNC(fast_reverse_into, const FastList&, FastList&)
+    fast_list FUNC(fast_reverse_into, const FastListI64&, FastListI64&)
+    fast_list FUNC(fast_reverse_into, const FastListF32&, FastListF32&)
+    fast_list FUNC(fast_reverse_into, const FastListF64&, FastListF64&)
+    fast_list FUNC(fast_reverse_into, const FastListU8&, FastListU8&)
+    fast_list FUNC(fast_sum, const std::vector<int>&)
+    fast_list FUNC(fast_sum, const std::vector<int64_t>&)
+    fast_list FUNC(fast_sum, const std::vector<double>&)
+    fast_list FUNC(fast_sum, const std::vector<float>&)
+    fast_list FUNC(fast_sum, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_sum_checked, const std::vector<int>&)
+    fast_list FUNC(fast_sum_checked, const std::vector<int64_t>&)
+    fast_list FUNC(fast_sum_checked, const std::vector<double>&)
+    fast_list FUNC(fast_sum_checked, const std::vector<float>&)
+    fast_list FUNC(fast_sum_checked, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_max, const std::vector<int>&)
+    fast_list FUNC(fast_max, const std::vector<int64_t>&)
+    fast_list FUNC(fast_max, const std::vector<double>&)
+    fast_list FUNC(fast_max, const std::vector<float>&)
+    fast_list FUNC(fast_max, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_min, const std::vector<int>&)
+    fast_list FUNC(fast_min, const std::vector<int64_t>&)
+    fast_list FUNC(fast_min, const std::vector<double>&)
+    fast_list FUNC(fast_min, const std::vector<float>&)
+    fast_list FUNC(fast_min, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_stats, const std::vector<int>&)
+    fast_list FUNC(fast_stats, const std::vector<int64_t>&)
+    fast_list FUNC(fast_stats, const std::vector<double>&)
+    fast_list FUNC(fast_stats, const std::vector<float>&)
+    fast_list FUNC(fast_stats, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_topk, const std::vector<int>&, int)
+    fast_list FUNC(fast_topk, const std::vector<int64_t>&, int)
+    fast_list FUNC(fast_topk, const std::vector<double>&, int)
+    fast_list FUNC(fast_topk, const std::vector<float>&, int)
+    fast_list FUNC(fast_topk, const std::vector<uint8_t>&, int)
+    fast_list FUNC(fast_nth, const std::vector<int>&, int)
+    fast_list FUNC(fast_nth, const std::vector<int64_t>&, int)
+    fast_list FUNC(fast_nth, const std::vector<double>&, int)
+    fast_list FUNC(fast_nth, const std::vector<float>&, int)
+    fast_list FUNC(fast_nth, const std::vector<uint8_t>&, int)
+    fast_list FUNC(fast_partial_sort, const std::vector<int>&, int)
+    fast_list FUNC(fast_partial_sort, const std::vector<int64_t>&, int)
+    fast_list FUNC(fast_partial_sort, const std::vector<double>&, int)
+    fast_list FUNC(fast_partial_sort, const std::vector<float>&, int)
+    fast_list FUNC(fast_partial_sort, const std::vector<uint8_t>&, int)
+    fast_list FUNC(fast_quantiles, const std::vector<int>&, const std::vector<double>&)
+    fast_list FUNC(fast_quantiles, const std::vector<int64_t>&, const std::vector<double>&)
+    fast_list FUNC(fast_quantiles, const std::vector<double>&, const std::vector<double>&)
+    fast_list FUNC(fast_quantiles, const std::vector<float>&, const std::vector<double>&)
+    fast_list FUNC(fast_quantiles, const std::vector<uint8_t>&, const std::vector<double>&)
+    fast_list FUNC(fast_argsort, const std::vector<int>&, bool)
+    fast_list FUNC(fast_argsort, const std::vector<int64_t>&, bool)
+    fast_list FUNC(fast_argsort, const std::vector<double>&, bool)
+    fast_list FUNC(fast_argsort, const std::vector<float>&, bool)
+    fast_list FUNC(fast_argsort, const std::vector<uint8_t>&, bool)
+    fast_list FUNC(fast_sort_by_key, const std::vector<int>&, const std::vector<int>&)
+    fast_list FUNC(fast_sort_by_key, const std::vector<int64_t>&, const std::vector<int64_t>&)
+    fast_list FUNC(fast_sort_by_key, const std::vector<double>&, const std::vector<double>&)
+    fast_list FUNC(fast_sort_by_key, const std::vector<float>&, const std::vector<float>&)
+    fast_list FUNC(fast_sort_by_key, const std::vector<uint8_t>&, const std::vector<uint8_t>&)
+    fast_list FUNC(fast_sort_buffer)
+    fast_list FUNC(fast_reverse_buffer)
+    fast_list FUNC(fast_sum_buffer)
+    fast_list FUNC(fast_min_buffer)
+    fast_list FUNC(fast_max_buffer)
+    fast_list FUNC(fast_stats_buffer)
+    fast_list FUNC(fast_set_num_threads)
+    fast_list FUNC(fast_get_num_threads)
 )
@@ -1,60 +1,2453 @@
 #include "fast_list.h"
 #include <numeric>
 #include <limits>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define FAST_LIST_X86_DISPATCH 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FAST_LIST_PREFETCH_WRITE(address) __builtin_prefetch((address), 1)
+#else
+#define FAST_LIST_PREFETCH_WRITE(address) ((void)0)
+#endif
 
 namespace includecpp {
 
-FastList::FastList() {
+namespace {
+
+// Four independent accumulators break the add dependency chain
+template <typename T>
+SumType<T> sum_generic(const T* data, size_t count) {
+    WrappingSum<T> acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 += data[i];
+        acc1 += data[i + 1];
+        acc2 += data[i + 2];
+        acc3 += data[i + 3];
+    }
+    for (; i < count; i++) {
+        acc0 += data[i];
+    }
+    return static_cast<SumType<T>>((acc0 + acc1) + (acc2 + acc3));
+}
+
+#ifdef FAST_LIST_X86_DISPATCH
+
+// Widen 8 ints per load to two vectors of 4 int64 lanes, 16 ints per iteration
+__attribute__((target("avx2")))
+int64_t sum_avx2(const int* data, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1)));
+        acc2 = _mm256_add_epi64(acc2, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(b)));
+        acc3 = _mm256_add_epi64(acc3, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(b, 1)));
+    }
+    __m256i acc = _mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3));
+    // Lanes and tail combine in uint64_t so overflow wraps like sum_generic
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t tail = static_cast<uint64_t>(sum_generic(data + i, count - i));
+    return static_cast<int64_t>((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + tail);
+}
+
+// Same scheme with 8 int64 lanes per vector, 32 ints per iteration (the
+// zero-masked widening form avoids GCC's undefined-vector warning)
+__attribute__((target("avx512f")))
+int64_t sum_avx512(const int* data, size_t count) {
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    __m512i acc2 = _mm512_setzero_si512();
+    __m512i acc3 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + i);
+        acc0 = _mm512_add_epi64(acc0, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p + 1)));
+        acc2 = _mm512_add_epi64(acc2, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p + 2)));
+        acc3 = _mm512_add_epi64(acc3, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p + 3)));
+    }
+    __m512i acc = _mm512_add_epi64(_mm512_add_epi64(acc0, acc1), _mm512_add_epi64(acc2, acc3));
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    uint64_t tail = static_cast<uint64_t>(sum_generic(data + i, count - i));
+    return static_cast<int64_t>(((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+                                + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7])) + tail);
+}
+
+#endif
+
+// Copy data[indices[i]] to out[i] for indices already known to be in range
+template <typename T>
+void gather_scalar(const T* data, const int* indices, size_t count, T* out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = data[indices[i]];
+    }
+}
+
+#ifdef FAST_LIST_X86_DISPATCH
+
+// Eight int32 lanes per hardware gather
+__attribute__((target("avx2")))
+void gather_avx2(const int* data, const int* indices, size_t count, int* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(data, index, 4));
+    }
+    gather_scalar(data, indices + i, count - i, out + i);
+}
+
+#endif
+
+// out[i] = carry + data[0] + ... + data[i]
+template <typename T>
+void prefix_scan_scalar(const T* data, size_t count, WrappingSum<T> carry, WrappingSum<T>* out) {
+    for (size_t i = 0; i < count; i++) {
+        carry += data[i];
+        out[i] = carry;
+    }
+}
+
+#ifdef FAST_LIST_X86_DISPATCH
+
+// Widen 4 ints to int64 lanes and scan them in-register with two
+// shift-and-add steps, then add the running carry broadcast to every lane
+__attribute__((target("avx2")))
+void prefix_scan_avx2(const int* data, size_t count, uint64_t carry, uint64_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i running = _mm256_set1_epi64x(static_cast<long long>(carry));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x90), zero, 0x03));
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x40), zero, 0x0F));
+        v = _mm256_add_epi64(v, running);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+        running = _mm256_permute4x64_epi64(v, 0xFF);
+    }
+    if (i > 0) {
+        carry = out[i - 1];
+    }
+    prefix_scan_scalar(data + i, count - i, carry, out + i);
+}
+
+#endif
+
+using SumKernel = int64_t (*)(const int*, size_t);
+using ScanKernel = void (*)(const int*, size_t, uint64_t, uint64_t*);
+using GatherKernel = void (*)(const int*, const int*, size_t, int*);
+
+// Pick the widest kernel the running CPU supports
+SumKernel select_sum_kernel() {
+#ifdef FAST_LIST_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return sum_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return sum_avx2;
+    }
+#endif
+    return sum_generic<int>;
+}
+
+ScanKernel select_scan_kernel() {
+#ifdef FAST_LIST_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return prefix_scan_avx2;
+    }
+#endif
+    return prefix_scan_scalar<int>;
+}
+
+template <typename T>
+void prefix_scan(const T* data, size_t count, WrappingSum<T> carry, WrappingSum<T>* out) {
+    if constexpr (std::is_same<T, int>::value) {
+        static const ScanKernel kernel = select_scan_kernel();
+        kernel(data, count, carry, out);
+    } else {
+        prefix_scan_scalar(data, count, carry, out);
+    }
+}
+
+// Empty slot in the range-extreme structures
+constexpr uint32_t NO_POSITION = 0xFFFFFFFFu;
+
+inline size_t lowest_bit(size_t i) {
+    return i & (~i + 1);
+}
+
+GatherKernel select_gather_kernel() {
+#ifdef FAST_LIST_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return gather_avx2;
+    }
+#endif
+    return gather_scalar<int>;
+}
+
+// Elements per fast_stats block: the lane partials are reduced and merged
+// once per block, and block positions fit the uint32 lane argmin/argmax
+constexpr size_t STATS_BLOCK = 4096;
+
+// Independent accumulators in fast_stats: eight fill an AVX2 register of
+// int32 lanes
+constexpr size_t STATS_LANES = 8;
+
+// Per-lane partials of one fast_stats block; lane l sees the elements at
+// block positions congruent to l mod STATS_LANES. Deviations are taken
+// from shift (the block's first element) so the sum of squares does not
+// cancel against a large mean.
+template <typename T>
+struct StatsLanes {
+    WrappingSum<T> sum[STATS_LANES];
+    double dev[STATS_LANES];
+    double dev2[STATS_LANES];
+    T min[STATS_LANES];
+    T max[STATS_LANES];
+    uint32_t argmin[STATS_LANES];
+    uint32_t argmax[STATS_LANES];
+    double shift;
+
+    explicit StatsLanes(T first) : sum(), dev(), dev2(), argmin(), argmax(), shift(static_cast<double>(first)) {
+        std::fill(min, min + STATS_LANES, first);
+        std::fill(max, max + STATS_LANES, first);
+    }
+};
+
+// Fold block positions [i, n) into their lanes with branch-free selects;
+// strict compares keep the first occurrence within a lane
+template <typename T>
+void stats_lanes_scalar(const T* block, size_t i, size_t n, StatsLanes<T>& lanes) {
+    for (; i < n; i++) {
+        const size_t lane = i % STATS_LANES;
+        const T x = block[i];
+        const uint32_t position = static_cast<uint32_t>(i);
+        lanes.sum[lane] += x;
+        const double d = static_cast<double>(x) - lanes.shift;
+        lanes.dev[lane] += d;
+        lanes.dev2[lane] += d * d;
+        const bool lower = x < lanes.min[lane];
+        const bool higher = lanes.max[lane] < x;
+        lanes.min[lane] = lower ? x : lanes.min[lane];
+        lanes.argmin[lane] = lower ? position : lanes.argmin[lane];
+        lanes.max[lane] = higher ? x : lanes.max[lane];
+        lanes.argmax[lane] = higher ? position : lanes.argmax[lane];
+    }
+}
+
+template <typename T>
+void stats_block_scalar(const T* block, size_t n, StatsLanes<T>& lanes) {
+    stats_lanes_scalar(block, 0, n, lanes);
+}
+
+#ifdef FAST_LIST_X86_DISPATCH
+
+// The same lanes held in registers: compare masks blend both the running
+// extreme and its position, sums widen to int64 and deviations to double
+__attribute__((target("avx2")))
+void stats_block_avx2(const int* block, size_t n, StatsLanes<int>& lanes) {
+    const __m256d shift = _mm256_set1_pd(lanes.shift);
+    __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.min));
+    __m256i max = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.max));
+    __m256i argmin = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.argmin));
+    __m256i argmax = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.argmax));
+    __m256i sum_low = _mm256_setzero_si256(), sum_high = _mm256_setzero_si256();
+    __m256d dev_low = _mm256_setzero_pd(), dev_high = _mm256_setzero_pd();
+    __m256d dev2_low = _mm256_setzero_pd(), dev2_high = _mm256_setzero_pd();
+    __m256i position = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(static_cast<int>(STATS_LANES));
+    size_t i = 0;
+    for (; i + STATS_LANES <= n; i += STATS_LANES) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        const __m256i lower = _mm256_cmpgt_epi32(min, x);
+        const __m256i higher = _mm256_cmpgt_epi32(x, max);
+        min = _mm256_blendv_epi8(min, x, lower);
+        argmin = _mm256_blendv_epi8(argmin, position, lower);
+        max = _mm256_blendv_epi8(max, x, higher);
+        argmax = _mm256_blendv_epi8(argmax, position, higher);
+        position = _mm256_add_epi32(position, step);
+
+        const __m128i low = _mm256_castsi256_si128(x);
+        const __m128i high = _mm256_extracti128_si256(x, 1);
+        sum_low = _mm256_add_epi64(sum_low, _mm256_cvtepi32_epi64(low));
+        sum_high = _mm256_add_epi64(sum_high, _mm256_cvtepi32_epi64(high));
+        const __m256d d_low = _mm256_sub_pd(_mm256_cvtepi32_pd(low), shift);
+        const __m256d d_high = _mm256_sub_pd(_mm256_cvtepi32_pd(high), shift);
+        dev_low = _mm256_add_pd(dev_low, d_low);
+        dev_high = _mm256_add_pd(dev_high, d_high);
+        dev2_low = _mm256_add_pd(dev2_low, _mm256_mul_pd(d_low, d_low));
+        dev2_high = _mm256_add_pd(dev2_high, _mm256_mul_pd(d_high, d_high));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.min), min);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.max), max);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.argmin), argmin);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.argmax), argmax);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.sum), sum_low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.sum + 4), sum_high);
+    _mm256_storeu_pd(lanes.dev, dev_low);
+    _mm256_storeu_pd(lanes.dev + 4, dev_high);
+    _mm256_storeu_pd(lanes.dev2, dev2_low);
+    _mm256_storeu_pd(lanes.dev2 + 4, dev2_high);
+    stats_lanes_scalar(block, i, n, lanes);
+}
+
+#endif
+
+using StatsKernel = void (*)(const int*, size_t, StatsLanes<int>&);
+
+StatsKernel select_stats_kernel() {
+#ifdef FAST_LIST_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return stats_block_avx2;
+    }
+#endif
+    return stats_block_scalar<int>;
+}
+
+template <typename T>
+void stats_block(const T* block, size_t n, StatsLanes<T>& lanes) {
+    if constexpr (std::is_same<T, int>::value) {
+        static const StatsKernel kernel = select_stats_kernel();
+        kernel(block, n, lanes);
+    } else {
+        stats_block_scalar(block, n, lanes);
+    }
+}
+
+// Largest accepted growth factor; beyond it a single add could reserve
+// far more memory than any list needs
+constexpr double MAX_GROWTH_FACTOR = 64.0;
+
+// Below these sizes std::sort beats the radix sort, whose fixed cost is a
+// histogram of 256 counters per key byte plus a scratch buffer. From
+// "fast_list_bench crossover" on random keys (x86-64, GCC -O2): 4- and
+// 8-byte keys cross over between 0.8k and 2.5k elements, 1-byte keys between
+// 50 and 100; "fast_list_bench sizes" shows the radix sort 3-8x faster than
+// std::sort from 10^4 to 10^6 elements (15-20x for 1-byte keys).
+constexpr size_t RADIX_SORT_THRESHOLD = 2048;
+constexpr size_t BYTE_RADIX_SORT_THRESHOLD = 128;
+
+template <typename Key>
+constexpr size_t radix_sort_threshold() {
+    return sizeof(Key) == 1 ? BYTE_RADIX_SORT_THRESHOLD : RADIX_SORT_THRESHOLD;
+}
+
+// Order-preserving map from each element type onto an unsigned key of the
+// same width, so a single unsigned radix sort serves every type
+template <typename T> struct RadixKey;
+
+template <> struct RadixKey<int> {
+    using Key = uint32_t;
+    static Key encode(int value) { return static_cast<Key>(value) ^ 0x80000000u; }
+    static int decode(Key key) { return static_cast<int>(key ^ 0x80000000u); }
+};
+
+template <> struct RadixKey<int64_t> {
+    using Key = uint64_t;
+    static Key encode(int64_t value) { return static_cast<Key>(value) ^ (Key(1) << 63); }
+    static int64_t decode(Key key) { return static_cast<int64_t>(key ^ (Key(1) << 63)); }
+};
+
+template <> struct RadixKey<uint8_t> {
+    using Key = uint8_t;
+    static Key encode(uint8_t value) { return value; }
+    static uint8_t decode(Key key) { return key; }
+};
+
+// IEEE floats: flip every bit of negatives and only the sign of the rest
+template <typename F, typename Bits>
+struct FloatRadixKey {
+    using Key = Bits;
+    static constexpr Bits SIGN = Bits(1) << (sizeof(Bits) * 8 - 1);
+    static Key encode(F value) {
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & SIGN) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | SIGN);
+    }
+    static F decode(Key key) {
+        Bits bits = (key & SIGN) ? static_cast<Bits>(key & ~SIGN) : static_cast<Bits>(~key);
+        F value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+template <> struct RadixKey<float> : FloatRadixKey<float, uint32_t> {};
+template <> struct RadixKey<double> : FloatRadixKey<double, uint64_t> {};
+
+template <typename Key>
+inline size_t digit_of(Key key, unsigned shift) {
+    return static_cast<size_t>((key >> shift) & 0xFF);
+}
+
+// A radix key with a payload that travels with it (an index for argsort, a
+// value for sort_by_key)
+template <typename Key, typename Value>
+struct KeyedItem {
+    Key key;
+    Value value;
+};
+
+// Items handled by the radix sorts are bare keys or KeyedItems
+template <typename Key>
+inline Key key_of(Key key) {
+    return key;
+}
+
+template <typename Key, typename Value>
+inline Key key_of(const KeyedItem<Key, Value>& item) {
+    return item.key;
+}
+
+template <typename Item>
+using ItemKey = decltype(key_of(std::declval<Item>()));
+
+// LSD radix sort of unsigned keys on 8-bit digits. All histograms come from a
+// single read of the input, and passes whose digit is the same for every
+// element are skipped.
+template <typename Item>
+void radix_sort_keys(Item* keys, size_t count) {
+    constexpr int PASSES = sizeof(ItemKey<Item>);
+    std::vector<Item> scratch(count);
+
+    size_t histogram[PASSES][256] = {};
+    for (size_t i = 0; i < count; i++) {
+        const ItemKey<Item> key = key_of(keys[i]);
+        for (int pass = 0; pass < PASSES; pass++) {
+            histogram[pass][digit_of(key, pass * 8)]++;
+        }
+    }
+
+    Item* src = keys;
+    Item* dst = scratch.data();
+    for (int pass = 0; pass < PASSES; pass++) {
+        const unsigned shift = pass * 8;
+        size_t* counts = histogram[pass];
+        if (counts[digit_of(key_of(src[0]), shift)] == count) {
+            continue;
+        }
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            const size_t c = counts[digit];
+            counts[digit] = offset;
+            offset += c;
+        }
+        // Scatter writes land in up to 256 streams; prefetch the slot the
+        // element a few positions ahead will be written to
+        const size_t ahead = 16;
+        for (size_t i = 0; i < count; i++) {
+            if (i + ahead < count) {
+                FAST_LIST_PREFETCH_WRITE(dst + counts[digit_of(key_of(src[i + ahead]), shift)]);
+            }
+            const Item value = src[i];
+            dst[counts[digit_of(key_of(value), shift)]++] = value;
+        }
+        std::swap(src, dst);
+    }
+    if (src != keys) {
+        std::copy(src, src + count, keys);
+    }
+}
+
+// Persistent worker threads; the calling thread acts as worker 0
+class SortThreadPool {
+public:
+    explicit SortThreadPool(int count) : task(nullptr), generation(0), pending(0), stopping(false) {
+        for (int w = 1; w < count; w++) {
+            workers.emplace_back([this, w] { worker_loop(w); });
+        }
+    }
+
+    ~SortThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    SortThreadPool(const SortThreadPool&) = delete;
+    SortThreadPool& operator=(const SortThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Run work(worker_index) on every worker and wait for all of them
+    void run(const std::function<void(int)>& work) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &work;
+            pending = static_cast<int>(workers.size());
+            generation++;
+        }
+        start_cv.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [this] { return pending == 0; });
+        task = nullptr;
+    }
+
+private:
+    void worker_loop(int index) {
+        size_t seen = 0;
+        while (true) {
+            const std::function<void(int)>* work;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                work = task;
+            }
+            (*work)(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            done_cv.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    const std::function<void(int)>* task;
+    size_t generation;
+    int pending;
+    bool stopping;
+};
+
+// Each thread needs enough elements to amortize its 256-bucket histograms;
+// "fast_list_bench crossover" reports where the pooled sort overtakes the
+// serial one on the machine at hand
+constexpr size_t PARALLEL_SORT_THRESHOLD = size_t(1) << 17;
+constexpr size_t PARALLEL_MIN_PER_THREAD = size_t(1) << 15;
+
+// Read without pool_mutex, so setting or querying the count never waits for
+// a sort that holds the pool; the next acquire_pool resizes the pool
+std::atomic<int> requested_threads(std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+std::unique_ptr<SortThreadPool> shared_pool;
+std::mutex pool_mutex;  // One parallel operation at a time owns the pool
+
+// Workers that get a chunk of count elements; the rest of the pool idles
+int busy_workers(const SortThreadPool& pool, size_t count) {
+    return static_cast<int>(std::max<size_t>(1, std::min<size_t>(pool.size(), count / PARALLEL_MIN_PER_THREAD)));
+}
+
+// Parallel LSD radix sort. Every pass splits the source into one contiguous
+// chunk per worker; per-chunk histograms are laid out digit-major, thread-minor,
+// so the scatter is stable and the result does not depend on scheduling.
+// Memory overhead is one scratch copy plus 256 counters per worker.
+template <typename Item>
+void parallel_radix_sort_keys(Item* keys, size_t count, SortThreadPool& pool) {
+    constexpr int PASSES = sizeof(ItemKey<Item>);
+    const int threads = busy_workers(pool, count);
+    std::vector<Item> scratch(count);
+    std::vector<size_t> counts(static_cast<size_t>(threads) * 256);
+    Item* src = keys;
+    Item* dst = scratch.data();
+
+    auto chunk_begin = [count, threads](int t) { return count * t / threads; };
+
+    for (int pass = 0; pass < PASSES; pass++) {
+        const unsigned shift = pass * 8;
+        pool.run([&](int t) {
+            if (t >= threads) return;
+            size_t* local = counts.data() + static_cast<size_t>(t) * 256;
+            std::fill(local, local + 256, 0);
+            for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; i++) {
+                local[digit_of(key_of(src[i]), shift)]++;
+            }
+        });
+
+        // Skip the pass when all elements share this digit
+        const size_t first_digit = digit_of(key_of(src[0]), shift);
+        size_t same = 0;
+        for (int t = 0; t < threads; t++) {
+            same += counts[static_cast<size_t>(t) * 256 + first_digit];
+        }
+        if (same == count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            for (int t = 0; t < threads; t++) {
+                size_t& slot = counts[static_cast<size_t>(t) * 256 + digit];
+                const size_t c = slot;
+                slot = offset;
+                offset += c;
+            }
+        }
+
+        pool.run([&](int t) {
+            if (t >= threads) return;
+            size_t* local = counts.data() + static_cast<size_t>(t) * 256;
+            const size_t end = chunk_begin(t + 1);
+            const size_t ahead = 16;
+            for (size_t i = chunk_begin(t); i < end; i++) {
+                if (i + ahead < end) {
+                    FAST_LIST_PREFETCH_WRITE(dst + local[digit_of(key_of(src[i + ahead]), shift)]);
+                }
+                const Item value = src[i];
+                dst[local[digit_of(key_of(value), shift)]++] = value;
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != keys) {
+        pool.run([&](int t) {
+            if (t >= threads) return;
+            std::copy(src + chunk_begin(t), src + chunk_begin(t + 1), keys + chunk_begin(t));
+        });
+    }
+}
+
+// The shared pool when count is large enough to split and no other
+// operation is using it; lock (deferred on entry) then holds pool_mutex
+SortThreadPool* acquire_pool(std::unique_lock<std::mutex>& lock, size_t count) {
+    if (count < PARALLEL_SORT_THRESHOLD || !lock.try_lock()) {
+        return nullptr;
+    }
+    const int threads = requested_threads.load();
+    if (threads <= 1) {
+        lock.unlock();
+        return nullptr;
+    }
+    if (!shared_pool || shared_pool->size() != threads) {
+        shared_pool.reset();
+        shared_pool.reset(new SortThreadPool(threads));
+    }
+    return shared_pool.get();
+}
+
+// Run body(begin, end) over [0, count), split into one chunk per busy
+// worker when a pool is given
+template <typename Body>
+void for_chunks(SortThreadPool* pool, size_t count, const Body& body) {
+    if (!pool) {
+        body(size_t(0), count);
+        return;
+    }
+    const int threads = busy_workers(*pool, count);
+    pool->run([&](int t) {
+        if (t < threads) body(count * t / threads, count * (t + 1) / threads);
+    });
+}
+
+// The strict order every sort and selection uses: < for integers, radix-key
+// order for floats, so -0.0 precedes 0.0 and NaNs sit at the ends
+template <typename T>
+struct KeyLess {
+    bool operator()(T a, T b) const {
+        if constexpr (std::is_floating_point<T>::value) {
+            return RadixKey<T>::encode(a) < RadixKey<T>::encode(b);
+        } else {
+            return a < b;
+        }
+    }
+};
+
+template <typename T>
+struct KeyGreater {
+    bool operator()(T a, T b) const { return KeyLess<T>()(b, a); }
+};
+
+// Sort with as many workers as the input can keep busy, up to the
+// configured thread count. Integers become keys in place, since an element
+// may be accessed through the unsigned type of its width. Float storage must
+// not be read as integers, so floats are encoded into a separate key buffer,
+// one more copy of the data.
+template <typename T>
+void sort_dispatch(T* data, size_t count) {
+    using Key = typename RadixKey<T>::Key;
+    if (count < radix_sort_threshold<Key>()) {
+        std::sort(data, data + count, KeyLess<T>());
+        return;
+    }
+    std::unique_lock<std::mutex> lock(pool_mutex, std::defer_lock);
+    SortThreadPool* pool = acquire_pool(lock, count);
+    std::unique_ptr<Key[]> buffer;
+    Key* keys;
+    if constexpr (std::is_integral<T>::value) {
+        keys = reinterpret_cast<Key*>(data);
+    } else {
+        buffer.reset(new Key[count]);
+        keys = buffer.get();
+    }
+    for_chunks(pool, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) keys[i] = RadixKey<T>::encode(data[i]);
+    });
+    if (pool) {
+        parallel_radix_sort_keys(keys, count, *pool);
+    } else {
+        radix_sort_keys(keys, count);
+    }
+    for_chunks(pool, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) data[i] = RadixKey<T>::decode(keys[i]);
+    });
+}
+
+// Value of rank n (ascending, n < count) without reordering data. Large
+// inputs bucket the top key digit in parallel, copy out only the elements
+// of the bucket holding rank n, and finish those with introselect.
+template <typename T>
+T select_nth(const T* data, size_t count, size_t n) {
+    using Key = typename RadixKey<T>::Key;
+    std::unique_lock<std::mutex> lock(pool_mutex, std::defer_lock);
+    SortThreadPool* pool = acquire_pool(lock, count);
+    if (!pool) {
+        std::vector<T> copy(data, data + count);
+        std::nth_element(copy.begin(), copy.begin() + n, copy.end(), KeyLess<T>());
+        return copy[n];
+    }
+
+    const unsigned shift = 8 * (sizeof(Key) - 1);
+    const int threads = busy_workers(*pool, count);
+    auto chunk_begin = [count, threads](int t) { return count * t / threads; };
+    std::vector<size_t> counts(static_cast<size_t>(threads) * 256);
+    pool->run([&](int t) {
+        if (t >= threads) return;
+        size_t* local = counts.data() + static_cast<size_t>(t) * 256;
+        for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; i++) {
+            local[digit_of(RadixKey<T>::encode(data[i]), shift)]++;
+        }
+    });
+
+    size_t bucket = 0, below = 0;
+    for (;; bucket++) {
+        size_t in_bucket = 0;
+        for (int t = 0; t < threads; t++) {
+            in_bucket += counts[static_cast<size_t>(t) * 256 + bucket];
+        }
+        if (n < below + in_bucket) break;
+        below += in_bucket;
+    }
+
+    // Each chunk's share of the bucket is known, so the copy needs no locking
+    std::vector<size_t> offsets(threads + 1, 0);
+    for (int t = 0; t < threads; t++) {
+        offsets[t + 1] = offsets[t] + counts[static_cast<size_t>(t) * 256 + bucket];
+    }
+    std::vector<T> candidates(offsets[threads]);
+    pool->run([&](int t) {
+        if (t >= threads) return;
+        T* out = candidates.data() + offsets[t];
+        for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; i++) {
+            if (digit_of(RadixKey<T>::encode(data[i]), shift) == bucket) {
+                *out++ = data[i];
+            }
+        }
+    });
+    lock.unlock();
+
+    std::nth_element(candidates.begin(), candidates.begin() + (n - below), candidates.end(), KeyLess<T>());
+    return candidates[n - below];
+}
+
+// The k extreme elements under Compare, best first; the k-th of them has
+// ascending rank cutoff. Small inputs keep a k-element heap in one pass;
+// large ones select the cutoff in parallel and collect what beats it.
+template <typename T, typename Compare>
+void select_k(const T* data, size_t count, size_t k, size_t cutoff, T* out, Compare better) {
+    if (k == 0) {
+        return;
+    }
+    if (count < PARALLEL_SORT_THRESHOLD || k == count) {
+        std::partial_sort_copy(data, data + count, out, out + k, better);
+        return;
+    }
+    const T threshold = select_nth(data, count, cutoff);
+    size_t taken = 0;
+    for (size_t i = 0; i < count && taken < k; i++) {
+        if (better(data[i], threshold)) {
+            out[taken++] = data[i];
+        }
+    }
+    std::fill(out + taken, out + k, threshold);
+    std::sort(out, out + k, better);
+}
+
+// Sort count payloads by the matching keys. load(i) supplies payload i;
+// store(i, item) receives the item that ends up at position i. Small inputs
+// use a comparison sort (stable only on request); the radix path, serial or
+// parallel, is always stable.
+template <typename T, typename Value, typename Load, typename Store>
+void keyed_sort(const T* keys, size_t count, bool stable, const Load& load, const Store& store) {
+    using Item = KeyedItem<typename RadixKey<T>::Key, Value>;
+    std::vector<Item> items(count);
+    std::unique_lock<std::mutex> lock(pool_mutex, std::defer_lock);
+    SortThreadPool* pool = acquire_pool(lock, count);
+    for_chunks(pool, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            items[i].key = RadixKey<T>::encode(keys[i]);
+            items[i].value = load(i);
+        }
+    });
+    auto by_key = [](const Item& a, const Item& b) { return a.key < b.key; };
+    if (count < radix_sort_threshold<typename RadixKey<T>::Key>()) {
+        if (stable) {
+            std::stable_sort(items.begin(), items.end(), by_key);
+        } else {
+            std::sort(items.begin(), items.end(), by_key);
+        }
+    } else if (pool) {
+        parallel_radix_sort_keys(items.data(), count, *pool);
+    } else {
+        radix_sort_keys(items.data(), count);
+    }
+    for_chunks(pool, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            store(i, items[i]);
+        }
+    });
+}
+
+// Size output like input; its elements are then rewritten wholesale, so
+// whatever it maintains over them is stale
+template <typename T>
+void prepare_output(const BasicFastList<T>& input, BasicFastList<T>& output) {
+    if (&input != &output) {
+        output.reserve(static_cast<int>(input.data.size()));   // Throws while output is pinned and too small
+        output.data.resize(input.data.size());
+    }
+    output.invalidate_aggregates();
+}
+
+template <typename T>
+void sort_into(const BasicFastList<T>& input, BasicFastList<T>& output) {
+    prepare_output(input, output);
+    fast_sort_copy_n(input.data.data(), output.data.data(), input.data.size());
+}
+
+template <typename T>
+void reverse_into(const BasicFastList<T>& input, BasicFastList<T>& output) {
+    prepare_output(input, output);
+    fast_reverse_copy_n(input.data.data(), output.data.data(), input.data.size());
+}
+
+int64_t add_checked(int64_t total, int64_t part) {
+    if ((part > 0 && total > std::numeric_limits<int64_t>::max() - part)
+        || (part < 0 && total < std::numeric_limits<int64_t>::min() - part)) {
+        throw std::overflow_error("fast_sum: result does not fit in int64");
+    }
+    return total + part;
+}
+
+// Number of elements of range(start, stop, step), 0 when empty; more than
+// a list can index (size() is an int) throws std::length_error
+template <typename T>
+size_t range_length(T start, T stop, T step) {
+    constexpr int MAX_LENGTH = std::numeric_limits<int>::max();
+    if constexpr (std::is_floating_point<T>::value) {
+        if (step == 0) {
+            return 0;
+        }
+        const double n = std::ceil((static_cast<double>(stop) - start) / step);
+        if (!(n > 0)) {
+            return 0;   // Also covers NaN bounds
+        }
+        if (n > static_cast<double>(MAX_LENGTH)) {
+            throw std::length_error("extend_range: too many elements");
+        }
+        return static_cast<size_t>(n);
+    } else {
+        // Unsigned 64-bit arithmetic handles spans that overflow T
+        uint64_t n;
+        if (step > 0) {
+            if (stop <= start) return 0;
+            const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(stop)) - static_cast<uint64_t>(static_cast<int64_t>(start));
+            n = (span - 1) / static_cast<uint64_t>(step) + 1;
+        } else {
+            if (step == 0 || stop >= start) return 0;
+            const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(start)) - static_cast<uint64_t>(static_cast<int64_t>(stop));
+            const uint64_t magnitude = uint64_t(0) - static_cast<uint64_t>(static_cast<int64_t>(step));
+            n = (span - 1) / magnitude + 1;
+        }
+        if (n > static_cast<uint64_t>(MAX_LENGTH)) {
+            throw std::length_error("extend_range: too many elements");
+        }
+        return static_cast<size_t>(n);
+    }
+}
+
+template <typename T>
+T range_value(T start, T step, size_t i) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return static_cast<T>(start + static_cast<double>(i) * step);
+    } else {
+            return static_cast<T>(static_cast<uint64_t>(static_cast<int64_t>(start))
+                              + i * static_cast<uint64_t>(static_cast<int64_t>(step)));
+    }
+}
+
+// a + b with the wrapping semantics of the integer sum kernels
+template <typename S>
+S add_sums(S a, S b) {
+    if constexpr (std::is_integral<S>::value) {
+        return static_cast<S>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+    } else {
+        return a + b;
+    }
+}
+
+}  // namespace
+
+template <typename T>
+BasicFastList<T>::BasicFastList()
+    : growth_factor(2.0), bounds_policy(BOUNDS_FILL), fill_value(0), track_aggregates(false),
+      sum_valid(false), running_extremes_valid(false), tracked_sum(0), tracked_min(0), tracked_max(0),
+      range_index(RANGE_INDEX_NONE), range_valid(0), extreme_index(EXTREME_INDEX_NONE), range_extreme_valid(false),
+      segment_leaves(0), extreme_size(0) {
     data.clear();
 }
 
-void FastList::add(int value) {
+template <typename T>
+void BasicFastList<T>::add(T value) {
+    grow_for(1);
     data.push_back(value);
+    if (range_indexed()) {
+        range_index_append(data.size() - 1);
+    }
+    if (extreme_index != EXTREME_INDEX_NONE) {
+        extreme_index_append(data.size() - 1);
+    }
+    if (track_aggregates) {
+        if (sum_valid) {
+            tracked_sum = add_sums<SumType<T>>(tracked_sum, value);
+        }
+        if (data.size() == 1) {
+            tracked_min = tracked_max = value;
+            running_extremes_valid = true;
+        } else if (running_extremes_valid) {
+            tracked_min = std::min(tracked_min, value);
+            tracked_max = std::max(tracked_max, value);
+        }
+    }
 }
 
-int FastList::get(int index) {
-    if (index < 0 || index >= static_cast<int>(data.size())) {
-        return 0;
-    }
-    return data[index];
+template <typename T>
+T BasicFastList<T>::get(int index) {
+    return resolve_index(index) ? data[index] : fill_value;
 }
 
-int FastList::size() {
+template <typename T>
+int BasicFastList<T>::size() {
     return static_cast<int>(data.size());
 }
 
-void FastList::clear() {
+template <typename T>
+void BasicFastList<T>::clear() {
     data.clear();
+    tracked_sum = 0;
+    sum_valid = true;
+    running_extremes_valid = false;
+    range_index_truncate();
+    range_extreme_valid = false;
+}
+
+template <typename T>
+SumType<T> BasicFastList<T>::sum() const {
+    if (!track_aggregates) {
+        return fast_sum_n(data.data(), data.size());
+    }
+    if (!sum_valid) {
+        tracked_sum = fast_sum_n(data.data(), data.size());
+        sum_valid = true;
+    }
+    return tracked_sum;
+}
+
+template <typename T>
+T BasicFastList<T>::minimum() const {
+    if (!track_aggregates || data.empty()) {
+        return fast_min_n(data.data(), data.size());
+    }
+    if (!running_extremes_valid) {
+        tracked_min = fast_min_n(data.data(), data.size());
+        tracked_max = fast_max_n(data.data(), data.size());
+        running_extremes_valid = true;
+    }
+    return tracked_min;
+}
+
+template <typename T>
+T BasicFastList<T>::maximum() const {
+    if (!track_aggregates || data.empty()) {
+        return fast_max_n(data.data(), data.size());
+    }
+    if (!running_extremes_valid) {
+        minimum();
+    }
+    return tracked_max;
+}
+
+template <typename T>
+void BasicFastList<T>::set_track_aggregates(bool enabled) {
+    track_aggregates = enabled;
+    invalidate_aggregates();
+}
+
+template <typename T>
+bool BasicFastList<T>::get_track_aggregates() const {
+    return track_aggregates;
+}
+
+template <typename T>
+void BasicFastList<T>::invalidate_aggregates() {
+    sum_valid = false;
+    running_extremes_valid = false;
+    range_valid = 0;
+    range_extreme_valid = false;
+}
+
+// Fold elements [begin, size()) that were just appended into the aggregates
+template <typename T>
+void BasicFastList<T>::note_appended(size_t begin) {
+    const size_t count = data.size() - begin;
+    if (range_indexed() && count > 0) {
+        range_index_append(begin);
+    }
+    if (extreme_index != EXTREME_INDEX_NONE && count > 0) {
+        extreme_index_append(begin);
+    }
+    if (!track_aggregates || count == 0) {
+        return;
+    }
+    const T* values = data.data() + begin;
+    if (sum_valid) {
+        tracked_sum = add_sums(tracked_sum, fast_sum_n(values, count));
+    }
+    if (begin == 0 || running_extremes_valid) {
+        const T low = fast_min_n(values, count);
+        const T high = fast_max_n(values, count);
+        tracked_min = begin == 0 ? low : std::min(tracked_min, low);
+        tracked_max = begin == 0 ? high : std::max(tracked_max, high);
+        running_extremes_valid = true;
+    }
+}
+
+// Account for data[index] about to be replaced by value
+template <typename T>
+void BasicFastList<T>::note_overwrite(size_t index, T value) {
+    if (range_indexed()) {
+        range_index_overwrite(index, value);
+    }
+    if (!track_aggregates) {
+        return;
+    }
+    const T old = data[index];
+    if (sum_valid) {
+        if constexpr (std::is_integral<T>::value) {
+            tracked_sum = static_cast<SumType<T>>(static_cast<uint64_t>(tracked_sum) + static_cast<uint64_t>(value)
+                                                  - static_cast<uint64_t>(old));
+        } else {
+            sum_valid = false;   // Subtracting would let rounding error accumulate
+        }
+    }
+    if (running_extremes_valid) {
+        if ((old == tracked_min && value > old) || (old == tracked_max && value < old)) {
+            running_extremes_valid = false;
+        } else {
+            tracked_min = std::min(tracked_min, value);
+            tracked_max = std::max(tracked_max, value);
+        }
+    }
 }
 
-std::vector<int> fast_sort(const std::vector<int>& input) {
-    std::vector<int> result = input;
-    std::sort(result.begin(), result.end());
+template <typename T>
+BasicFastList<T> BasicFastList<T>::sorted() const {
+    BasicFastList result;
+    result.data = data;
+    fast_sort_n(result.data.data(), result.data.size());
     return result;
 }
 
-std::vector<int> fast_reverse(const std::vector<int>& input) {
-    std::vector<int> result = input;
-    std::reverse(result.begin(), result.end());
+template <typename T>
+BasicFastList<T> BasicFastList<T>::reversed() const {
+    BasicFastList result;
+    result.data.assign(data.rbegin(), data.rend());
     return result;
 }
 
-int64_t fast_sum(const std::vector<int>& input) {
-    return std::accumulate(input.begin(), input.end(), static_cast<int64_t>(0));
+template <typename T>
+BasicFastStats<T> BasicFastList<T>::stats() const {
+    return fast_stats_n(data.data(), data.size());
 }
 
-int fast_max(const std::vector<int>& input) {
-    if (input.empty()) {
-        return 0;
+template <typename T>
+void BasicFastList<T>::sort() {
+    fast_sort_n(data.data(), data.size());
+    range_valid = 0;
+    range_extreme_valid = false;
+}
+
+template <typename T>
+void BasicFastList<T>::reverse() {
+    fast_reverse_n(data.data(), data.size());
+    range_valid = 0;
+    range_extreme_valid = false;
+}
+
+template <typename T>
+std::vector<T> BasicFastList<T>::to_list() const {
+    return data;
+}
+
+template <typename T>
+T* BasicFastList<T>::acquire_view() {
+    views.count++;
+    return data.data();
+}
+
+template <typename T>
+void BasicFastList<T>::release_view() {
+    if (views.count == 0) {
+        throw std::logic_error("release_view: no view to release");
     }
-    return *std::max_element(input.begin(), input.end());
+    views.count--;
 }
 
-int fast_min(const std::vector<int>& input) {
-    if (input.empty()) {
-        return 0;
+template <typename T>
+int BasicFastList<T>::view_count() const {
+    return views.count;
+}
+
+// Refuse to move the elements out from under a live view
+template <typename T>
+void BasicFastList<T>::check_storage(size_t needed) const {
+    if (views.count > 0 && needed > data.capacity()) {
+        throw std::runtime_error("FastList: cannot grow past capacity() while as_numpy views are alive");
+    }
+}
+
+template <typename T>
+int BasicFastList<T>::capacity() const {
+    return static_cast<int>(data.capacity());
+}
+
+template <typename T>
+int BasicFastList<T>::itemsize() const {
+    return static_cast<int>(sizeof(T));
+}
+
+// Reserve room for extra more elements following the growth policy
+template <typename T>
+void BasicFastList<T>::grow_for(size_t extra) {
+    const size_t needed = data.size() + extra;
+    if (needed <= data.capacity()) {
+        return;
+    }
+    check_storage(needed);
+    const double scaled = static_cast<double>(data.capacity()) * growth_factor;
+    const bool use_scaled = scaled > static_cast<double>(needed) && scaled < static_cast<double>(data.max_size());
+    data.reserve(use_scaled ? static_cast<size_t>(scaled) : needed);
+}
+
+template <typename T>
+void BasicFastList<T>::extend(const std::vector<T>& values) {
+    const size_t begin = data.size();
+    grow_for(values.size());
+    data.insert(data.end(), values.begin(), values.end());
+    note_appended(begin);
+}
+
+template <typename T>
+void BasicFastList<T>::extend_list(const BasicFastList& other) {
+    const size_t begin = data.size();
+    if (&other == this) {
+        // insert() may not read from the vector it grows
+        grow_for(begin);
+        data.resize(2 * begin);
+        std::copy_n(data.begin(), begin, data.begin() + begin);
+    } else {
+        grow_for(other.data.size());
+        data.insert(data.end(), other.data.begin(), other.data.end());
+    }
+    note_appended(begin);
+}
+
+template <typename T>
+void BasicFastList<T>::extend_range(T start, T stop, T step) {
+    const size_t count = range_length(start, stop, step);
+    if (count == 0) {
+        return;
+    }
+    const size_t begin = data.size();
+    grow_for(count);
+    data.resize(begin + count);
+    T* out = data.data() + begin;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = range_value(start, step, i);
+    }
+    note_appended(begin);
+}
+
+template <typename T>
+void BasicFastList<T>::reserve(int count) {
+    if (count > 0) {
+        check_storage(static_cast<size_t>(count));
+        data.reserve(static_cast<size_t>(count));
+    }
+}
+
+template <typename T>
+void BasicFastList<T>::resize(int count, T fill) {
+    const size_t target = static_cast<size_t>(std::max(0, count));
+    const size_t begin = data.size();
+    if (target < begin) {
+        sum_valid = false;
+        running_extremes_valid = false;
+    } else {
+        grow_for(target - begin);
+    }
+    data.resize(target, fill);
+    if (target > begin) {
+        note_appended(begin);
+    } else {
+        range_index_truncate();
+        range_extreme_valid = false;
     }
-    return *std::min_element(input.begin(), input.end());
 }
 
+template <typename T>
+void BasicFastList<T>::set_growth_factor(double factor) {
+    if (!(factor <= MAX_GROWTH_FACTOR)) {
+        throw std::invalid_argument("set_growth_factor: factor must be a number no larger than 64");
+    }
+    growth_factor = factor;
+}
+
+template <typename T>
+double BasicFastList<T>::get_growth_factor() const {
+    return growth_factor;
+}
+
+// Apply the bounds policy to one index. Returns false when the element
+// should be skipped (fill policy, or clip on an empty list).
+template <typename T>
+bool BasicFastList<T>::resolve_index(int& index) const {
+    const int count = static_cast<int>(data.size());
+    if (index >= 0 && index < count) {
+        return true;
+    }
+    if (bounds_policy == BOUNDS_RAISE) {
+        throw std::out_of_range("FastList index " + std::to_string(index) + " out of range for size "
+                                + std::to_string(count));
+    }
+    if (bounds_policy == BOUNDS_CLIP && count > 0) {
+        index = index < 0 ? 0 : count - 1;
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+void BasicFastList<T>::gather_into(const int* indices, size_t count, T* out) const {
+    // One vectorized min/max pass decides whether the unchecked kernel applies
+    const bool in_range = count == 0
+        || (fast_min_n(indices, count) >= 0 && fast_max_n(indices, count) < static_cast<int>(data.size()));
+    if (in_range) {
+        if constexpr (sizeof(T) == sizeof(int) && std::is_integral<T>::value) {
+            static const GatherKernel kernel = select_gather_kernel();
+            kernel(reinterpret_cast<const int*>(data.data()), indices, count, reinterpret_cast<int*>(out));
+        } else {
+            gather_scalar(data.data(), indices, count, out);
+        }
+        return;
+    }
+    if (bounds_policy == BOUNDS_RAISE) {
+        for (size_t i = 0; i < count; i++) {
+            int index = indices[i];
+            resolve_index(index);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        int index = indices[i];
+        out[i] = resolve_index(index) ? data[index] : fill_value;
+    }
+}
+
+template <typename T>
+void BasicFastList<T>::scatter_from(const int* indices, const T* values, size_t count) {
+    const bool in_range = count == 0
+        || (fast_min_n(indices, count) >= 0 && fast_max_n(indices, count) < static_cast<int>(data.size()));
+    if (in_range) {
+        if (observed()) {
+            for (size_t i = 0; i < count; i++) {
+                write_element(indices[i], values[i]);
+            }
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            data[indices[i]] = values[i];
+        }
+        return;
+    }
+    // Validate everything first so that raise leaves the list untouched
+    if (bounds_policy == BOUNDS_RAISE) {
+        for (size_t i = 0; i < count; i++) {
+            int index = indices[i];
+            resolve_index(index);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        int index = indices[i];
+        if (resolve_index(index)) {
+            write_element(index, values[i]);
+        }
+    }
+}
+
+template <typename T>
+BasicFastList<T> BasicFastList<T>::gather(const std::vector<int>& indices) const {
+    BasicFastList result;
+    result.data.resize(indices.size());
+    gather_into(indices.data(), indices.size(), result.data.data());
+    return result;
+}
+
+template <typename T>
+BasicFastList<T> BasicFastList<T>::gather_list(const BasicFastList<int>& indices) const {
+    BasicFastList result;
+    result.data.resize(indices.data.size());
+    gather_into(indices.data.data(), indices.data.size(), result.data.data());
+    return result;
+}
+
+template <typename T>
+void BasicFastList<T>::scatter(const std::vector<int>& indices, const std::vector<T>& values) {
+    if (indices.size() != values.size()) {
+        throw std::invalid_argument("scatter: indices and values differ in length");
+    }
+    scatter_from(indices.data(), values.data(), indices.size());
+}
+
+template <typename T>
+void BasicFastList<T>::scatter_list(const BasicFastList<int>& indices, const BasicFastList& values) {
+    if (indices.data.size() != values.data.size()) {
+        throw std::invalid_argument("scatter: indices and values differ in length");
+    }
+    scatter_from(indices.data.data(), values.data.data(), indices.data.size());
+}
+
+template <typename T>
+void BasicFastList<T>::set(int index, T value) {
+    if (resolve_index(index)) {
+        write_element(index, value);
+    }
+}
+
+template <typename T>
+void BasicFastList<T>::set_bounds_policy(const std::string& policy) {
+    if (policy == "raise") bounds_policy = BOUNDS_RAISE;
+    else if (policy == "clip") bounds_policy = BOUNDS_CLIP;
+    else if (policy == "fill") bounds_policy = BOUNDS_FILL;
+    else throw std::invalid_argument("set_bounds_policy: unknown policy '" + policy + "'");
+}
+
+template <typename T>
+std::string BasicFastList<T>::get_bounds_policy() const {
+    switch (bounds_policy) {
+        case BOUNDS_RAISE: return "raise";
+        case BOUNDS_CLIP: return "clip";
+        default: return "fill";
+    }
+}
+
+template <typename T>
+void BasicFastList<T>::set_fill_value(T value) {
+    fill_value = value;
+}
+
+template <typename T>
+T BasicFastList<T>::get_fill_value() const {
+    return fill_value;
+}
+
+// Elements [begin, size()) were appended
+template <typename T>
+void BasicFastList<T>::range_index_append(size_t begin) {
+    const size_t count = data.size();
+    if (range_tree.size() != begin + 1) {
+        range_valid = 0;    // data was resized through the field
+    }
+    range_valid = std::min(range_valid, begin);
+    range_tree.resize(count + 1);
+    if (range_valid < begin) {
+        return;     // Stale anyway; the next query rebuilds
+    }
+    if (range_index == RANGE_INDEX_PREFIX) {
+        prefix_scan(data.data() + begin, count - begin, range_tree[begin], range_tree.data() + begin + 1);
+    } else {
+        // Node i covers (i - lowbit(i), i]: its own element plus the nodes
+        // that tile the rest of that span
+        for (size_t i = begin + 1; i <= count; i++) {
+            WrappingSum<T> node = data[i - 1];
+            for (size_t j = i - 1; j > i - lowest_bit(i); j -= lowest_bit(j)) {
+                node += range_tree[j];
+            }
+            range_tree[i] = node;
+        }
+    }
+    range_valid = count;
+}
+
+// data[index] is about to become value
+template <typename T>
+void BasicFastList<T>::range_index_overwrite(size_t index, T value) {
+    if (range_tree.size() != data.size() + 1) {
+        range_valid = 0;
+        return;
+    }
+    if (range_index == RANGE_INDEX_PREFIX || range_valid < data.size()) {
+        range_valid = std::min(range_valid, index);
+        return;
+    }
+    WrappingSum<T> delta = static_cast<WrappingSum<T>>(value);
+    delta -= static_cast<WrappingSum<T>>(data[index]);
+    for (size_t i = index + 1; i < range_tree.size(); i += lowest_bit(i)) {
+        range_tree[i] += delta;
+    }
+}
+
+// After a shrink: both layouts keep the entries of the surviving prefix
+template <typename T>
+void BasicFastList<T>::range_index_truncate() {
+    if (!range_indexed()) {
+        return;
+    }
+    range_tree.resize(data.size() + 1);
+    range_tree[0] = 0;
+    range_valid = std::min(range_valid, data.size());
+}
+
+template <typename T>
+void BasicFastList<T>::ensure_range_index() const {
+    const size_t count = data.size();
+    if (range_tree.size() != count + 1) {
+        range_valid = 0;    // data was resized through the field; no entry can be trusted
+    }
+    if (range_valid >= count) {
+        return;
+    }
+    range_tree.resize(count + 1);
+    range_tree[0] = 0;
+    if (range_index == RANGE_INDEX_PREFIX) {
+        prefix_scan(data.data() + range_valid, count - range_valid, range_tree[range_valid],
+                    range_tree.data() + range_valid + 1);
+    } else {
+        for (size_t i = 1; i <= count; i++) {
+            range_tree[i] = data[i - 1];
+        }
+        for (size_t i = 1; i <= count; i++) {
+            const size_t parent = i + lowest_bit(i);
+            if (parent <= count) {
+                range_tree[parent] += range_tree[i];
+            }
+        }
+    }
+    range_valid = count;
+}
+
+// Sum of the first count elements
+template <typename T>
+WrappingSum<T> BasicFastList<T>::range_prefix(size_t count) const {
+    if (range_index == RANGE_INDEX_PREFIX) {
+        return range_tree[count];
+    }
+    WrappingSum<T> total = 0;
+    for (size_t i = count; i > 0; i -= lowest_bit(i)) {
+        total += range_tree[i];
+    }
+    return total;
+}
+
+template <typename T>
+SumType<T> BasicFastList<T>::range_sum(int lo, int hi) const {
+    const int count = static_cast<int>(data.size());
+    lo = std::max(0, std::min(lo, count));
+    hi = std::max(lo, std::min(hi, count));
+    if (!range_indexed()) {
+        return fast_sum_n(data.data() + lo, static_cast<size_t>(hi - lo));
+    }
+    ensure_range_index();
+    return static_cast<SumType<T>>(range_prefix(hi) - range_prefix(lo));
+}
+
+template <typename T>
+void BasicFastList<T>::set_range_sum_index(const std::string& kind) {
+    RangeSumIndex chosen;
+    if (kind == "none") chosen = RANGE_INDEX_NONE;
+    else if (kind == "prefix") chosen = RANGE_INDEX_PREFIX;
+    else if (kind == "fenwick") chosen = RANGE_INDEX_FENWICK;
+    else throw std::invalid_argument("set_range_sum_index: unknown index '" + kind + "'");
+    range_index = chosen;
+    range_valid = 0;
+    if (!range_indexed()) {
+        range_tree.clear();
+        range_tree.shrink_to_fit();
+    } else {
+        ensure_range_index();
+    }
+}
+
+template <typename T>
+std::string BasicFastList<T>::get_range_sum_index() const {
+    switch (range_index) {
+        case RANGE_INDEX_PREFIX: return "prefix";
+        case RANGE_INDEX_FENWICK: return "fenwick";
+        default: return "none";
+    }
+}
+
+// Whether range_sum answers from range_tree. Float lists never do: the
+// difference of two running totals cancels (a slice after 1e17 sums to 0),
+// and Fenwick deltas would accumulate rounding error with every set.
+template <typename T>
+bool BasicFastList<T>::range_indexed() const {
+    return std::is_integral<T>::value && range_index != RANGE_INDEX_NONE;
+}
+
+// Whether any maintained aggregate or index watches element writes
+template <typename T>
+bool BasicFastList<T>::observed() const {
+    return track_aggregates || range_indexed() || extreme_index != EXTREME_INDEX_NONE;
+}
+
+// Overwrite one element and bring every maintained structure up to date
+template <typename T>
+void BasicFastList<T>::write_element(size_t index, T value) {
+    if (!observed()) {
+        data[index] = value;
+        return;
+    }
+    note_overwrite(index, value);
+    data[index] = value;
+    if (extreme_index != EXTREME_INDEX_NONE) {
+        extreme_index_written(index);
+    }
+}
+
+// The preferred of two positions for min (which = 0) or max (which = 1);
+// ties go to the leftmost position, and NO_POSITION loses to anything
+template <typename T>
+uint32_t BasicFastList<T>::pick_extreme(uint32_t a, uint32_t b, int which) const {
+    if (a == NO_POSITION) return b;
+    if (b == NO_POSITION) return a;
+    const T x = data[a], y = data[b];
+    const bool b_better = which == 0 ? (y < x) : (x < y);
+    const bool a_better = which == 0 ? (x < y) : (y < x);
+    if (b_better) return b;
+    if (a_better) return a;
+    return std::min(a, b);
+}
+
+template <typename T>
+void BasicFastList<T>::ensure_extreme_index() const {
+    if ((range_extreme_valid && extreme_size == data.size()) || extreme_index == EXTREME_INDEX_NONE) {
+        return;
+    }
+    const size_t count = data.size();
+    for (int which = 0; which < 2; which++) {
+        if (extreme_index == EXTREME_INDEX_SPARSE) {
+            // Level k holds the best position of every window of 2^k elements
+            auto& levels = sparse_levels[which];
+            levels.assign(count > 0 ? 1 : 0, std::vector<uint32_t>(count));
+            for (size_t i = 0; i < count; i++) {
+                levels[0][i] = static_cast<uint32_t>(i);
+            }
+            for (size_t k = 1; (size_t(1) << k) <= count; k++) {
+                const size_t half = size_t(1) << (k - 1);
+                std::vector<uint32_t> level(count - (size_t(1) << k) + 1);
+                for (size_t i = 0; i < level.size(); i++) {
+                    level[i] = pick_extreme(levels[k - 1][i], levels[k - 1][i + half], which);
+                }
+                levels.push_back(std::move(level));
+            }
+        } else {
+            size_t leaves = 1;
+            while (leaves < count) leaves <<= 1;
+            segment_leaves = leaves;
+            auto& nodes = segment_nodes[which];
+            nodes.assign(2 * leaves, NO_POSITION);
+            for (size_t i = 0; i < count; i++) {
+                nodes[leaves + i] = static_cast<uint32_t>(i);
+            }
+            for (size_t p = leaves - 1; p >= 1; p--) {
+                nodes[p] = pick_extreme(nodes[2 * p], nodes[2 * p + 1], which);
+            }
+        }
+    }
+    extreme_size = count;
+    range_extreme_valid = true;
+}
+
+// Elements [begin, size()) were appended
+template <typename T>
+void BasicFastList<T>::extreme_index_append(size_t begin) {
+    const size_t count = data.size();
+    if (!range_extreme_valid || extreme_size != begin) {
+        range_extreme_valid = false;      // Includes data resized through the field
+        return;
+    }
+    if (extreme_index == EXTREME_INDEX_SEGMENT && count > segment_leaves) {
+        range_extreme_valid = false;      // Out of leaves: rebuild at twice the size on the next query
+        return;
+    }
+    for (size_t n = begin + 1; n <= count; n++) {
+        const uint32_t position = static_cast<uint32_t>(n - 1);
+        for (int which = 0; which < 2; which++) {
+            if (extreme_index == EXTREME_INDEX_SPARSE) {
+                // Element n - 1 completes one new window per level
+                auto& levels = sparse_levels[which];
+                if (levels.empty()) levels.emplace_back();
+                levels[0].push_back(position);
+                for (size_t k = 1; (size_t(1) << k) <= n; k++) {
+                    if (levels.size() == k) levels.emplace_back();
+                    const size_t i = n - (size_t(1) << k);
+                    levels[k].push_back(pick_extreme(levels[k - 1][i], levels[k - 1][i + (size_t(1) << (k - 1))], which));
+                }
+            } else {
+                auto& nodes = segment_nodes[which];
+                size_t p = segment_leaves + position;
+                nodes[p] = position;
+                for (p >>= 1; p >= 1; p >>= 1) {
+                    nodes[p] = pick_extreme(nodes[2 * p], nodes[2 * p + 1], which);
+                }
+            }
+        }
+    }
+    extreme_size = count;
+}
+
+// data[index] was overwritten
+template <typename T>
+void BasicFastList<T>::extreme_index_written(size_t index) {
+    if (!range_extreme_valid) {
+        return;
+    }
+    if (extreme_index == EXTREME_INDEX_SPARSE || extreme_size != data.size()) {
+        range_extreme_valid = false;
+        return;
+    }
+    for (int which = 0; which < 2; which++) {
+        auto& nodes = segment_nodes[which];
+        for (size_t p = (segment_leaves + index) >> 1; p >= 1; p >>= 1) {
+            nodes[p] = pick_extreme(nodes[2 * p], nodes[2 * p + 1], which);
+        }
+    }
+}
+
+// Best position in [lo, hi) for min (which = 0) or max (which = 1), -1 if empty
+template <typename T>
+int BasicFastList<T>::range_extreme(int lo, int hi, int which) const {
+    const int count = static_cast<int>(data.size());
+    lo = std::max(0, std::min(lo, count));
+    hi = std::max(lo, std::min(hi, count));
+    if (lo == hi) {
+        return -1;
+    }
+    if (extreme_index == EXTREME_INDEX_NONE) {
+        const T* begin = data.data() + lo;
+        const T* best = which == 0 ? std::min_element(begin, data.data() + hi) : std::max_element(begin, data.data() + hi);
+        return static_cast<int>(best - data.data());
+    }
+    ensure_extreme_index();
+    if (extreme_index == EXTREME_INDEX_SPARSE) {
+        // Two overlapping power-of-two windows cover the range
+        size_t k = 0;
+        while ((size_t(2) << k) <= static_cast<size_t>(hi - lo)) k++;
+        const auto& level = sparse_levels[which][k];
+        return static_cast<int>(pick_extreme(level[lo], level[hi - (size_t(1) << k)], which));
+    }
+    const auto& nodes = segment_nodes[which];
+    uint32_t best = NO_POSITION;
+    for (size_t l = lo + segment_leaves, r = hi + segment_leaves; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) best = pick_extreme(best, nodes[l++], which);
+        if (r & 1) best = pick_extreme(best, nodes[--r], which);
+    }
+    return static_cast<int>(best);
+}
+
+template <typename T>
+T BasicFastList<T>::range_min(int lo, int hi) const {
+    const int position = range_extreme(lo, hi, 0);
+    return position < 0 ? T(0) : data[position];
+}
+
+template <typename T>
+T BasicFastList<T>::range_max(int lo, int hi) const {
+    const int position = range_extreme(lo, hi, 1);
+    return position < 0 ? T(0) : data[position];
+}
+
+template <typename T>
+int BasicFastList<T>::range_argmin(int lo, int hi) const {
+    return range_extreme(lo, hi, 0);
+}
+
+template <typename T>
+int BasicFastList<T>::range_argmax(int lo, int hi) const {
+    return range_extreme(lo, hi, 1);
+}
+
+template <typename T>
+void BasicFastList<T>::set_range_extreme_index(const std::string& kind) {
+    RangeExtremeIndex chosen;
+    if (kind == "none") chosen = EXTREME_INDEX_NONE;
+    else if (kind == "sparse") chosen = EXTREME_INDEX_SPARSE;
+    else if (kind == "segment") chosen = EXTREME_INDEX_SEGMENT;
+    else throw std::invalid_argument("set_range_extreme_index: unknown index '" + kind + "'");
+    extreme_index = chosen;
+    range_extreme_valid = false;
+    for (int which = 0; which < 2; which++) {
+        sparse_levels[which].clear();
+        segment_nodes[which].clear();
+    }
+    segment_leaves = 0;
+    extreme_size = 0;
+    ensure_extreme_index();
+}
+
+template <typename T>
+std::string BasicFastList<T>::get_range_extreme_index() const {
+    switch (extreme_index) {
+        case EXTREME_INDEX_SPARSE: return "sparse";
+        case EXTREME_INDEX_SEGMENT: return "segment";
+        default: return "none";
+    }
+}
+
+// A deque of positions whose values are strictly monotone: the front is
+// the best of the current window, and each element enters and leaves once
+template <typename T>
+BasicFastList<T> BasicFastList<T>::sliding_extreme(int window, int which) const {
+    BasicFastList result;
+    const size_t count = data.size();
+    if (window <= 0 || static_cast<size_t>(window) > count) {
+        return result;
+    }
+    const size_t width = static_cast<size_t>(window);
+    result.data.resize(count - width + 1);
+    std::vector<size_t> deque(count);
+    size_t head = 0, tail = 0;
+    for (size_t i = 0; i < count; i++) {
+        const T x = data[i];
+        while (tail > head && (which == 0 ? !(data[deque[tail - 1]] < x) : !(x < data[deque[tail - 1]]))) {
+            tail--;
+        }
+        deque[tail++] = i;
+        if (deque[head] + width <= i) {
+            head++;
+        }
+        if (i + 1 >= width) {
+            result.data[i + 1 - width] = data[deque[head]];
+        }
+    }
+    return result;
+}
+
+template <typename T>
+BasicFastList<int> BasicFastList<T>::argsort(bool stable) const {
+    BasicFastList<int> result;
+    result.data.resize(data.size());
+    fast_argsort_n(data.data(), data.size(), stable, result.data.data());
+    return result;
+}
+
+template <typename T>
+template <typename V>
+void BasicFastList<T>::sort_by_key(BasicFastList<V>& values) {
+    if (values.data.size() != data.size()) {
+        throw std::invalid_argument("sort_by_key: keys and values differ in length");
+    }
+    if (static_cast<const void*>(&values) == static_cast<const void*>(this)) {
+        sort();
+        return;
+    }
+    fast_sort_by_key_n(data.data(), values.data.data(), data.size());
+    range_valid = 0;
+    range_extreme_valid = false;
+    values.range_valid = 0;
+    values.range_extreme_valid = false;
+}
+
+template <typename T>
+BasicFastList<T> BasicFastList<T>::topk(int k) const {
+    BasicFastList result;
+    result.data.resize(std::min(data.size(), static_cast<size_t>(std::max(0, k))));
+    fast_topk_n(data.data(), data.size(), result.data.size(), result.data.data());
+    return result;
+}
+
+template <typename T>
+BasicFastList<T> BasicFastList<T>::partial_sorted(int k) const {
+    BasicFastList result;
+    result.data.resize(std::min(data.size(), static_cast<size_t>(std::max(0, k))));
+    fast_partial_sort_n(data.data(), data.size(), result.data.size(), result.data.data());
+    return result;
+}
+
+template <typename T>
+T BasicFastList<T>::nth(int n) const {
+    if (n < 0) {
+        return 0;
+    }
+    return fast_nth_n(data.data(), data.size(), static_cast<size_t>(n));
+}
+
+template <typename T>
+std::vector<double> BasicFastList<T>::quantiles(const std::vector<double>& qs) const {
+    std::vector<double> result(qs.size());
+    fast_quantiles_n(data.data(), data.size(), qs.data(), qs.size(), result.data());
+    return result;
+}
+
+template <typename T>
+BasicFastList<T> BasicFastList<T>::sliding_min(int window) const {
+    return sliding_extreme(window, 0);
+}
+
+template <typename T>
+BasicFastList<T> BasicFastList<T>::sliding_max(int window) const {
+    return sliding_extreme(window, 1);
+}
+
+template <typename T>
+void fast_sort_n(T* data, size_t count) {
+    sort_dispatch(data, count);
+}
+
+template <typename T>
+void fast_topk_n(const T* data, size_t count, size_t k, T* out) {
+    k = std::min(k, count);
+    select_k(data, count, k, count - k, out, KeyGreater<T>());
+}
+
+template <typename T>
+void fast_partial_sort_n(const T* data, size_t count, size_t k, T* out) {
+    k = std::min(k, count);
+    select_k(data, count, k, k - 1, out, KeyLess<T>());
+}
+
+template <typename T>
+void fast_argsort_n(const T* data, size_t count, bool stable, int* out) {
+    if (count > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        throw std::length_error("argsort: too many elements for int indices");
+    }
+    using Item = KeyedItem<typename RadixKey<T>::Key, uint32_t>;
+    keyed_sort<T, uint32_t>(data, count, stable,
+        [](size_t i) { return static_cast<uint32_t>(i); },
+        [out](size_t i, const Item& item) { out[i] = static_cast<int>(item.value); });
+}
+
+template <typename K, typename V>
+void fast_sort_by_key_n(K* keys, V* values, size_t count) {
+    using Item = KeyedItem<typename RadixKey<K>::Key, V>;
+    keyed_sort<K, V>(keys, count, true,
+        [values](size_t i) { return values[i]; },
+        [keys, values](size_t i, const Item& item) {
+            keys[i] = RadixKey<K>::decode(item.key);
+            values[i] = item.value;
+        });
+}
+
+template <typename T>
+T fast_nth_n(const T* data, size_t count, size_t n) {
+    if (n >= count) {
+        return 0;
+    }
+    return select_nth(data, count, n);
+}
+
+// Linear interpolation between the two closest ranks (NumPy's default).
+// The ranks are selected in ascending order, each introselect running only
+// on the part of one shared copy that lies beyond the previous rank; large
+// inputs with few ranks use the parallel select per rank instead.
+template <typename T>
+void fast_quantiles_n(const T* data, size_t count, const double* qs, size_t q, double* out) {
+    if (count == 0) {
+        std::fill(out, out + q, 0.0);
+        return;
+    }
+    std::vector<size_t> ranks;
+    for (size_t j = 0; j < q; j++) {
+        if (qs[j] == qs[j]) {
+            const double position = std::min(1.0, std::max(0.0, qs[j])) * static_cast<double>(count - 1);
+            const size_t lower = static_cast<size_t>(position);
+            ranks.push_back(lower);
+            ranks.push_back(std::min(lower + 1, count - 1));
+        }
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+    std::vector<T> values(ranks.size());
+    if (count >= PARALLEL_SORT_THRESHOLD && fast_get_num_threads() > 1 && ranks.size() <= 16) {
+        for (size_t r = 0; r < ranks.size(); r++) {
+            values[r] = select_nth(data, count, ranks[r]);
+        }
+    } else {
+        std::vector<T> copy(data, data + count);
+        size_t begin = 0;
+        for (size_t r = 0; r < ranks.size(); r++) {
+            std::nth_element(copy.begin() + begin, copy.begin() + ranks[r], copy.end(), KeyLess<T>());
+            values[r] = copy[ranks[r]];
+            begin = ranks[r] + 1;
+        }
+    }
+
+    auto value_at = [&](size_t rank) {
+        return static_cast<double>(values[std::lower_bound(ranks.begin(), ranks.end(), rank) - ranks.begin()]);
+    };
+    for (size_t j = 0; j < q; j++) {
+        if (qs[j] != qs[j]) {
+            out[j] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        const double position = std::min(1.0, std::max(0.0, qs[j])) * static_cast<double>(count - 1);
+        const size_t lower = static_cast<size_t>(position);
+        const double low = value_at(lower);
+        const double high = value_at(std::min(lower + 1, count - 1));
+        out[j] = low + (position - static_cast<double>(lower)) * (high - low);
+    }
+}
+
+void fast_set_num_threads(int threads) {
+    requested_threads.store(std::max(1, threads));
+}
+
+int fast_get_num_threads() {
+    return requested_threads.load();
+}
+
+template <typename T>
+void fast_reverse_n(T* data, size_t count) {
+    std::reverse(data, data + count);
+}
+
+template <typename T>
+void fast_sort_copy_n(const T* input, T* output, size_t count) {
+    if (input != output) {
+        std::copy(input, input + count, output);
+    }
+    fast_sort_n(output, count);
+}
+
+template <typename T>
+void fast_reverse_copy_n(const T* input, T* output, size_t count) {
+    if (input == output) {
+        fast_reverse_n(output, count);
+        return;
+    }
+    std::reverse_copy(input, input + count, output);
+}
+
+template <typename T>
+SumType<T> fast_sum_n(const T* data, size_t count) {
+    if constexpr (std::is_same<T, int>::value) {
+        static const SumKernel kernel = select_sum_kernel();
+        return kernel(data, count);
+    } else {
+        return sum_generic(data, count);
+    }
+}
+
+template <typename T>
+SumType<T> fast_sum_checked_n(const T* data, size_t count) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return fast_sum_n(data, count);   // Floating sums saturate to inf rather than wrap
+    } else if constexpr (sizeof(T) < sizeof(int64_t)) {
+        // |element| <= 2^(8 * sizeof(T)), so a chunk of 2^(63 - 8 * sizeof(T))
+        // elements can never overflow int64 on its own
+        const size_t safe_chunk = size_t(1) << (63 - 8 * sizeof(T));
+        int64_t total = 0;
+        for (size_t begin = 0; begin < count; begin += safe_chunk) {
+            total = add_checked(total, fast_sum_n(data + begin, std::min(safe_chunk, count - begin)));
+        }
+        return total;
+    } else {
+        int64_t total = 0;
+        for (size_t i = 0; i < count; i++) {
+            total = add_checked(total, data[i]);
+        }
+        return total;
+    }
+}
+
+template <typename T>
+T fast_max_n(const T* data, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    return *std::max_element(data, data + count);
+}
+
+template <typename T>
+T fast_min_n(const T* data, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    return *std::min_element(data, data + count);
+}
+
+// One sweep over memory: each block is folded into lane-wise partials
+// (AVX2 compares and blends for int32, the same branch-free lanes in
+// scalar code elsewhere), the lanes are reduced with the lowest position
+// winning ties so first occurrence is kept, and blocks are merged with
+// Chan's parallel variance update.
+template <typename T>
+BasicFastStats<T> fast_stats_n(const T* data, size_t count) {
+    BasicFastStats<T> stats;
+    if (count == 0) {
+        return stats;
+    }
+    stats.min = data[0];
+    stats.max = data[0];
+    double m2 = 0.0;
+
+    for (size_t begin = 0; begin < count; begin += STATS_BLOCK) {
+        const size_t n = std::min(STATS_BLOCK, count - begin);
+        const T* block = data + begin;
+        StatsLanes<T> lanes(block[0]);
+        stats_block(block, n, lanes);
+
+        WrappingSum<T> block_sum = 0;
+        double dev = 0.0, dev2 = 0.0;
+        T block_min = lanes.min[0], block_max = lanes.max[0];
+        uint32_t block_argmin = lanes.argmin[0], block_argmax = lanes.argmax[0];
+        for (size_t lane = 0; lane < STATS_LANES; lane++) {
+            block_sum += lanes.sum[lane];
+            dev += lanes.dev[lane];
+            dev2 += lanes.dev2[lane];
+            if (lanes.min[lane] < block_min || (!(block_min < lanes.min[lane]) && lanes.argmin[lane] < block_argmin)) {
+                block_min = lanes.min[lane];
+                block_argmin = lanes.argmin[lane];
+            }
+            if (block_max < lanes.max[lane] || (!(lanes.max[lane] < block_max) && lanes.argmax[lane] < block_argmax)) {
+                block_max = lanes.max[lane];
+                block_argmax = lanes.argmax[lane];
+            }
+        }
+
+        // The shift is a sample, so this subtraction cancels no more than
+        // the spread of the block itself
+        const double block_mean = lanes.shift + dev / static_cast<double>(n);
+        const double block_m2 = std::max(0.0, dev2 - dev * dev / static_cast<double>(n));
+
+        if (block_min < stats.min) {
+            stats.min = block_min;
+            stats.argmin = static_cast<int64_t>(begin + block_argmin);
+        }
+        if (block_max > stats.max) {
+            stats.max = block_max;
+            stats.argmax = static_cast<int64_t>(begin + block_argmax);
+        }
+
+        const double before = static_cast<double>(stats.count);
+        const double total = before + static_cast<double>(n);
+        const double delta = block_mean - stats.mean;
+        stats.mean += delta * static_cast<double>(n) / total;
+        m2 += block_m2 + delta * delta * before * static_cast<double>(n) / total;
+        stats.sum = static_cast<SumType<T>>(static_cast<WrappingSum<T>>(stats.sum) + block_sum);
+        stats.count += static_cast<int64_t>(n);
+    }
+
+    if constexpr (std::is_integral<T>::value && sizeof(T) < sizeof(int64_t)) {
+        // The exact integer sum gives a correctly rounded mean
+        stats.mean = static_cast<double>(stats.sum) / static_cast<double>(stats.count);
+    }
+    stats.variance = m2 / static_cast<double>(stats.count);
+    return stats;
+}
+
+void fast_sort_into(const FastList& input, FastList& output) {
+    sort_into(input, output);
+}
+
+void fast_sort_into(const FastListI64& input, FastListI64& output) {
+    sort_into(input, output);
+}
+
+void fast_sort_into(const FastListF32& input, FastListF32& output) {
+    sort_into(input, output);
+}
+
+void fast_sort_into(const FastListF64& input, FastListF64& output) {
+    sort_into(input, output);
+}
+
+void fast_sort_into(const FastListU8& input, FastListU8& output) {
+    sort_into(input, output);
+}
+
+void fast_reverse_into(const FastList& input, FastList& output) {
+    reverse_into(input, output);
+}
+
+void fast_reverse_into(const FastListI64& input, FastListI64& output) {
+    reverse_into(input, output);
+}
+
+void fast_reverse_into(const FastListF32& input, FastListF32& output) {
+    reverse_into(input, output);
+}
+
+void fast_reverse_into(const FastListF64& input, FastListF64& output) {
+    reverse_into(input, output);
+}
+
+void fast_reverse_into(const FastListU8& input, FastListU8& output) {
+    reverse_into(input, output);
+}
+
+namespace {
+
+template <typename T>
+std::vector<T> sorted_vector(const std::vector<T>& input) {
+    std::vector<T> result = input;
+    fast_sort_n(result.data(), result.size());
+    return result;
+}
+
+template <typename T>
+std::vector<T> topk_vector(const std::vector<T>& input, int k) {
+    std::vector<T> result(std::min(input.size(), static_cast<size_t>(std::max(0, k))));
+    fast_topk_n(input.data(), input.size(), result.size(), result.data());
+    return result;
+}
+
+template <typename T>
+std::vector<T> partial_sort_vector(const std::vector<T>& input, int k) {
+    std::vector<T> result(std::min(input.size(), static_cast<size_t>(std::max(0, k))));
+    fast_partial_sort_n(input.data(), input.size(), result.size(), result.data());
+    return result;
+}
+
+template <typename T>
+T nth_vector(const std::vector<T>& input, int n) {
+    if (n < 0) {
+        return 0;
+    }
+    return fast_nth_n(input.data(), input.size(), static_cast<size_t>(n));
+}
+
+template <typename T>
+std::vector<double> quantiles_vector(const std::vector<T>& input, const std::vector<double>& qs) {
+    std::vector<double> result(qs.size());
+    fast_quantiles_n(input.data(), input.size(), qs.data(), qs.size(), result.data());
+    return result;
+}
+
+template <typename T>
+std::vector<int> argsort_vector(const std::vector<T>& input, bool stable) {
+    std::vector<int> result(input.size());
+    fast_argsort_n(input.data(), input.size(), stable, result.data());
+    return result;
+}
+
+template <typename T>
+std::vector<T> sort_by_key_vector(const std::vector<T>& keys, const std::vector<T>& values) {
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("sort_by_key: keys and values differ in length");
+    }
+    std::vector<T> sorted_keys(keys);
+    std::vector<T> result(values);
+    fast_sort_by_key_n(sorted_keys.data(), result.data(), result.size());
+    return result;
+}
+
+}  // namespace
+
+#ifdef FAST_LIST_PYTHON
+
+namespace {
+
+// Element types a Python buffer can carry into the kernels
+enum BufferType {
+    BUFFER_I32,
+    BUFFER_I64,
+    BUFFER_F32,
+    BUFFER_F64,
+    BUFFER_U8
+};
+
+template <typename T> constexpr BufferType buffer_type_of();
+template <> constexpr BufferType buffer_type_of<int>() { return BUFFER_I32; }
+template <> constexpr BufferType buffer_type_of<int64_t>() { return BUFFER_I64; }
+template <> constexpr BufferType buffer_type_of<float>() { return BUFFER_F32; }
+template <> constexpr BufferType buffer_type_of<double>() { return BUFFER_F64; }
+template <> constexpr BufferType buffer_type_of<uint8_t>() { return BUFFER_U8; }
+
+// Element type of a buffer the kernels can read in place: 1-D, contiguous,
+// aligned, and in native byte order. Anything else is rejected here, before
+// a pointer is formed.
+BufferType vector_buffer_type(const pybind11::buffer_info& info, const char* what) {
+    const std::string name(what);
+    if (info.ndim != 1) {
+        throw pybind11::value_error(name + ": buffer must be 1-D");
+    }
+    if (info.size > 1 && info.strides[0] != info.itemsize) {
+        throw pybind11::value_error(name + ": buffer must be contiguous");
+    }
+    if (info.size > 0 && reinterpret_cast<uintptr_t>(info.ptr) % static_cast<uintptr_t>(info.itemsize) != 0) {
+        throw pybind11::value_error(name + ": buffer is not aligned for its element type");
+    }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    const bool host_big_endian = true;
+#else
+    const bool host_big_endian = false;
+#endif
+    const std::string& format = info.format;
+    size_t at = 0;
+    if (!format.empty() && (format[0] == '@' || format[0] == '=' || format[0] == '<' || format[0] == '>'
+                            || format[0] == '!')) {
+        const bool big_endian = format[0] == '>' || format[0] == '!';
+        if ((format[0] == '<' || big_endian) && big_endian != host_big_endian) {
+            throw pybind11::type_error(name + ": buffer is not in native byte order");
+        }
+        at = 1;
+    }
+    const char code = format.size() == at + 1 ? format[at] : '\0';
+    if (code != '\0') {
+        if (std::strchr("bhilq", code)) {
+            if (info.itemsize == 4) return BUFFER_I32;
+            if (info.itemsize == 8) return BUFFER_I64;
+        } else if (std::strchr("BHILQ", code)) {
+            if (info.itemsize == 1) return BUFFER_U8;
+        } else if (code == 'f' && info.itemsize == 4) {
+            return BUFFER_F32;
+        } else if (code == 'd' && info.itemsize == 8) {
+            return BUFFER_F64;
+        }
+    }
+    throw pybind11::type_error(name + ": no kernel for buffer format '" + format + "'");
+}
+
+// visit(elements) with the buffer's elements as a typed pointer
+template <typename Visit>
+decltype(auto) visit_buffer(const pybind11::buffer_info& info, BufferType type, Visit&& visit) {
+    switch (type) {
+    case BUFFER_I32: return visit(static_cast<int*>(info.ptr));
+    case BUFFER_I64: return visit(static_cast<int64_t*>(info.ptr));
+    case BUFFER_F32: return visit(static_cast<float*>(info.ptr));
+    case BUFFER_F64: return visit(static_cast<double*>(info.ptr));
+    default: return visit(static_cast<uint8_t*>(info.ptr));
+    }
+}
+
+// Sorted or reversed input written to out: in place when out is input's own
+// storage, else into a same-sized buffer that must not overlap it. The GIL
+// is released once both buffers are held, for the kernel only.
+void transform_buffer(pybind11::buffer& input, pybind11::buffer& out, bool sort, const char* what) {
+    const pybind11::buffer_info source = input.request();
+    const pybind11::buffer_info target = out.request(true);    // BufferError if read-only
+    const BufferType type = vector_buffer_type(source, what);
+    if (vector_buffer_type(target, what) != type) {
+        throw pybind11::type_error(std::string(what) + ": out must have the input's element type");
+    }
+    if (target.size != source.size) {
+        throw pybind11::value_error(std::string(what) + ": out must have the input's length");
+    }
+    const uintptr_t first = reinterpret_cast<uintptr_t>(source.ptr);
+    const uintptr_t out_first = reinterpret_cast<uintptr_t>(target.ptr);
+    const uintptr_t bytes = static_cast<uintptr_t>(source.size * source.itemsize);
+    if (first != out_first && first < out_first + bytes && out_first < first + bytes) {
+        throw pybind11::value_error(std::string(what) + ": out overlaps the input without being the input");
+    }
+    const size_t count = static_cast<size_t>(source.size);
+    pybind11::gil_scoped_release release;
+    visit_buffer(target, type, [&](auto* output) {
+        using T = std::remove_pointer_t<decltype(output)>;
+        const T* data = static_cast<const T*>(source.ptr);
+        if (data == output) {
+            if (sort) fast_sort_n(output, count);
+            else fast_reverse_n(output, count);
+        } else if (sort) {
+            fast_sort_copy_n(data, output, count);
+        } else {
+            fast_reverse_copy_n(data, output, count);
+        }
+    });
+}
+
+// reduce(elements, count) over a read-only view of input, without the GIL
+template <typename Reduce>
+pybind11::object reduce_buffer(pybind11::buffer& input, const char* what, Reduce reduce) {
+    const pybind11::buffer_info info = input.request();
+    return visit_buffer(info, vector_buffer_type(info, what), [&](auto* data) {
+        auto result = [&] {
+            pybind11::gil_scoped_release release;
+            return reduce(data, static_cast<size_t>(info.size));
+        }();
+        return pybind11::cast(result);
+    });
+}
+
+}  // namespace
+
+template <typename T>
+pybind11::array BasicFastList<T>::view() {
+    // The array's base owns a reference to this list's Python object, so the
+    // list outlives the array, and releases the pin when the array goes
+    auto* owner = new pybind11::object(pybind11::cast(this, pybind11::return_value_policy::reference));
+    T* elements = acquire_view();
+    pybind11::capsule base(owner, [](void* pointer) {
+        auto* held = static_cast<pybind11::object*>(pointer);
+        held->cast<BasicFastList<T>*>()->release_view();
+        delete held;
+    });
+    return pybind11::array_t<T>({static_cast<pybind11::ssize_t>(data.size())}, {static_cast<pybind11::ssize_t>(sizeof(T))},
+                                elements, base);
+}
+
+template <typename T>
+void BasicFastList<T>::extend_buffer(pybind11::buffer values) {
+    const pybind11::buffer_info info = values.request();
+    if (vector_buffer_type(info, "extend_buffer") != buffer_type_of<T>()) {
+        throw pybind11::type_error("extend_buffer: buffer elements are not of the list's type");
+    }
+    const T* first = static_cast<const T*>(info.ptr);
+    const size_t count = static_cast<size_t>(info.size);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(first);
+    const uintptr_t storage = reinterpret_cast<uintptr_t>(data.data());
+    if (address >= storage && address < storage + data.capacity() * sizeof(T)) {
+        // A view of this list's own storage: read it before the storage grows
+        extend(std::vector<T>(first, first + count));
+        return;
+    }
+    const size_t begin = data.size();
+    grow_for(count);
+    data.insert(data.end(), first, first + count);
+    note_appended(begin);
+}
+
+void fast_sort_buffer(pybind11::buffer input, pybind11::buffer out) {
+    transform_buffer(input, out, true, "fast_sort_buffer");
+}
+
+void fast_reverse_buffer(pybind11::buffer input, pybind11::buffer out) {
+    transform_buffer(input, out, false, "fast_reverse_buffer");
+}
+
+pybind11::object fast_sum_buffer(pybind11::buffer input) {
+    return reduce_buffer(input, "fast_sum_buffer", [](auto* data, size_t count) { return fast_sum_n(data, count); });
+}
+
+pybind11::object fast_min_buffer(pybind11::buffer input) {
+    return reduce_buffer(input, "fast_min_buffer", [](auto* data, size_t count) { return fast_min_n(data, count); });
+}
+
+pybind11::object fast_max_buffer(pybind11::buffer input) {
+    return reduce_buffer(input, "fast_max_buffer", [](auto* data, size_t count) { return fast_max_n(data, count); });
+}
+
+pybind11::object fast_stats_buffer(pybind11::buffer input) {
+    return reduce_buffer(input, "fast_stats_buffer", [](auto* data, size_t count) { return fast_stats_n(data, count); });
+}
+
+#endif
+
+#define FAST_LIST_DEFINE_VECTOR_FUNCTIONS(T)                                                 \
+    std::vector<T> fast_sort(const std::vector<T>& input) { return sorted_vector(input); }  \
+    std::vector<T> fast_reverse(const std::vector<T>& input) {                               \
+        return std::vector<T>(input.rbegin(), input.rend());                                 \
+    }                                                                                        \
+    SumType<T> fast_sum(const std::vector<T>& input) {                                       \
+        return fast_sum_n(input.data(), input.size());                                       \
+    }                                                                                        \
+    SumType<T> fast_sum_checked(const std::vector<T>& input) {                               \
+        return fast_sum_checked_n(input.data(), input.size());                               \
+    }                                                                                        \
+    T fast_max(const std::vector<T>& input) { return fast_max_n(input.data(), input.size()); } \
+    T fast_min(const std::vector<T>& input) { return fast_min_n(input.data(), input.size()); } \
+    BasicFastStats<T> fast_stats(const std::vector<T>& input) {                              \
+        return fast_stats_n(input.data(), input.size());                                     \
+    }                                                                                        \
+    std::vector<T> fast_topk(const std::vector<T>& input, int k) { return topk_vector(input, k); } \
+    std::vector<T> fast_partial_sort(const std::vector<T>& input, int k) {                   \
+        return partial_sort_vector(input, k);                                                \
+    }                                                                                        \
+    T fast_nth(const std::vector<T>& input, int n) { return nth_vector(input, n); }          \
+    std::vector<double> fast_quantiles(const std::vector<T>& input, const std::vector<double>& qs) { \
+        return quantiles_vector(input, qs);                                                  \
+    }                                                                                        \
+    std::vector<int> fast_argsort(const std::vector<T>& input, bool stable) {                \
+        return argsort_vector(input, stable);                                                \
+    }                                                                                        \
+    std::vector<T> fast_sort_by_key(const std::vector<T>& keys, const std::vector<T>& values) { \
+        return sort_by_key_vector(keys, values);                                             \
+    }
+
+#define FAST_LIST_INSTANTIATE_BY_KEY(K, V)                                          \
+    template void fast_sort_by_key_n<K, V>(K*, V*, size_t);                         \
+    template void BasicFastList<K>::sort_by_key<V>(BasicFastList<V>&);
+
+#define FAST_LIST_INSTANTIATE(T)                                                    \
+    template class BasicFastList<T>;                                                \
+    template void fast_sort_n<T>(T*, size_t);                                       \
+    template void fast_reverse_n<T>(T*, size_t);                                    \
+    template void fast_sort_copy_n<T>(const T*, T*, size_t);                        \
+    template void fast_reverse_copy_n<T>(const T*, T*, size_t);                     \
+    template SumType<T> fast_sum_n<T>(const T*, size_t);                            \
+    template SumType<T> fast_sum_checked_n<T>(const T*, size_t);                    \
+    template T fast_max_n<T>(const T*, size_t);                                     \
+    template T fast_min_n<T>(const T*, size_t);                                     \
+    template BasicFastStats<T> fast_stats_n<T>(const T*, size_t);                   \
+    template void fast_topk_n<T>(const T*, size_t, size_t, T*);                     \
+    template void fast_partial_sort_n<T>(const T*, size_t, size_t, T*);             \
+    template T fast_nth_n<T>(const T*, size_t, size_t);                             \
+    template void fast_quantiles_n<T>(const T*, size_t, const double*, size_t, double*); \
+    template void fast_argsort_n<T>(const T*, size_t, bool, int*);                  \
+    FAST_LIST_INSTANTIATE_BY_KEY(T, int)                                            \
+    FAST_LIST_INSTANTIATE_BY_KEY(T, int64_t)                                        \
+    FAST_LIST_INSTANTIATE_BY_KEY(T, float)                                          \
+    FAST_LIST_INSTANTIATE_BY_KEY(T, double)                                         \
+    FAST_LIST_INSTANTIATE_BY_KEY(T, uint8_t)
+
+FAST_LIST_INSTANTIATE(int)
+FAST_LIST_INSTANTIATE(int64_t)
+FAST_LIST_INSTANTIATE(float)
+FAST_LIST_INSTANTIATE(double)
+FAST_LIST_INSTANTIATE(uint8_t)
+
+FAST_LIST_DEFINE_VECTOR_FUNCTIONS(int)
+FAST_LIST_DEFINE_VECTOR_FUNCTIONS(int64_t)
+FAST_LIST_DEFINE_VECTOR_FUNCTIONS(double)
+FAST_LIST_DEFINE_VECTOR_FUNCTIONS(float)
+FAST_LIST_DEFINE_VECTOR_FUNCTIONS(uint8_t)
+
+#undef FAST_LIST_INSTANTIATE
+#undef FAST_LIST_INSTANTIATE_BY_KEY
+#undef FAST_LIST_DEFINE_VECTOR_FUNCTIONS
+
 }
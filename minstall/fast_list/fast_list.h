@@ -2,23 +2,343 @@
 #include <vector>
 #include <algorithm>
 #include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+// Module builds compile against pybind11, which the buffer entry points
+// and views below need; the standalone test build has neither it nor Python.h
+#if __has_include(<pybind11/pybind11.h>) && __has_include(<Python.h>)
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#define FAST_LIST_PYTHON 1
+#endif
 
 namespace includecpp {
 
-class FastList {
+// Accumulator for sums: exact int64 for integer elements, double for floats
+template <typename T> struct SumTypeOf { using type = int64_t; };
+template <> struct SumTypeOf<float> { using type = double; };
+template <> struct SumTypeOf<double> { using type = double; };
+template <typename T> using SumType = typename SumTypeOf<T>::type;
+
+// Integer sums accumulate in uint64_t so int64 overflow wraps instead of
+// being undefined; fast_sum_checked_n is the variant that detects it
+template <typename T>
+using WrappingSum = typename std::conditional<std::is_integral<T>::value, uint64_t, SumType<T>>::type;
+
+// Result of fast_stats. Empty input leaves every field at zero;
+// variance is the population variance.
+template <typename T>
+struct BasicFastStats {
+    int64_t count = 0;
+    SumType<T> sum = 0;
+    T min = 0;
+    T max = 0;
+    int64_t argmin = 0;
+    int64_t argmax = 0;
+    double mean = 0.0;
+    double variance = 0.0;
+};
+
+// What get, gather, scatter and set do with an index outside [0, size()):
+// raise throws std::out_of_range before anything is written, clip clamps it
+// to the nearest element, fill reads the fill value (and drops the write).
+enum BoundsPolicy {
+    BOUNDS_RAISE = 0,
+    BOUNDS_CLIP = 1,
+    BOUNDS_FILL = 2
+};
+
+// Optional index behind BasicFastList::range_sum
+enum RangeSumIndex {
+    RANGE_INDEX_NONE = 0,       // Each query sums its slice
+    RANGE_INDEX_PREFIX = 1,     // Prefix array: O(1) queries, overwrites rebuild lazily
+    RANGE_INDEX_FENWICK = 2     // Fenwick tree: O(log n) queries and point updates
+};
+
+// Optional index behind BasicFastList::range_min/range_max and their argmin variants
+enum RangeExtremeIndex {
+    EXTREME_INDEX_NONE = 0,     // Each query scans its slice
+    EXTREME_INDEX_SPARSE = 1,   // Sparse table: O(1) queries, O(log n) appends, overwrites rebuild
+    EXTREME_INDEX_SEGMENT = 2   // Segment tree: O(log n) queries and point updates
+};
+
+// Every operation is available for int32, int64, float, double and uint8
+// elements; the member functions are instantiated in fast_list.cpp.
+template <typename T>
+class BasicFastList {
 public:
-    FastList();
-    std::vector<int> data;
-    void add(int value);
-    int get(int index);
+    BasicFastList();
+    std::vector<T> data;
+    void add(T value);
+    T get(int index);
     int size();
     void clear();
+
+    // Aggregates and reorderings computed directly on data, so no list
+    // conversion happens on the way in; results stay in a FastList
+    SumType<T> sum() const;
+    T minimum() const;
+    T maximum() const;
+    BasicFastList sorted() const;
+    BasicFastList reversed() const;
+    BasicFastStats<T> stats() const;
+
+    // In-place variants of sorted() and reversed()
+    void sort();
+    void reverse();
+
+    // Copy of the elements as a Python list (O(n); view() shares them instead)
+    std::vector<T> to_list() const;
+
+#ifdef FAST_LIST_PYTHON
+    // Zero-copy NumPy array over the elements. The array holds a reference
+    // to this list and pins its storage until the array is collected.
+    pybind11::array view();
+#endif
+
+    // A pinned storage: from acquire_view() to the matching release_view(),
+    // anything that would grow the list past capacity() throws
+    // std::runtime_error instead of moving the elements (shrinking and
+    // clear() keep the storage). Assigning data directly, from C++ or
+    // through the data attribute, is not checked. Copies of a list start
+    // with no views.
+    T* acquire_view();
+    void release_view();
+    int view_count() const;
+    int capacity() const;
+    int itemsize() const;
+
+    // Bulk construction: one binding crossing and one copy or fill each
+    void extend(const std::vector<T>& values);
+    void extend_list(const BasicFastList& other);
+#ifdef FAST_LIST_PYTHON
+    // Appends a 1-D contiguous buffer of this list's element type, checked
+    // like the *_buffer functions (TypeError for another element type)
+    void extend_buffer(pybind11::buffer values);
+#endif
+    void extend_range(T start, T stop, T step);         // Python range() / numpy.arange()
+    void reserve(int count);
+    void resize(int count, T fill);
+
+    // Capacity multiplier applied when add/extend outgrow the storage
+    // (default 2.0, values below 1.0 grow exactly to the needed size).
+    // Throws std::invalid_argument for NaN and for factors above 64.
+    void set_growth_factor(double factor);
+    double get_growth_factor() const;
+
+    // Batched element access, one binding crossing per batch. Indices
+    // outside the list follow the bounds policy, as in get ("fill" with 0 by
+    // default); later duplicates in a scatter win.
+    BasicFastList gather(const std::vector<int>& indices) const;
+    BasicFastList gather_list(const BasicFastList<int>& indices) const;
+    void scatter(const std::vector<int>& indices, const std::vector<T>& values);
+    void scatter_list(const BasicFastList<int>& indices, const BasicFastList& values);
+    void set(int index, T value);
+    void set_bounds_policy(const std::string& policy);   // "raise", "clip" or "fill", else std::invalid_argument
+    std::string get_bounds_policy() const;
+    void set_fill_value(T value);
+    T get_fill_value() const;
+
+    // Opt-in running aggregates: with tracking on, sum(), minimum() and
+    // maximum() answer in O(1). Appends update them in place; overwrites and
+    // removals that may have moved an extreme (or a float sum) mark them
+    // stale, and the next query rescans once. Writes that bypass the class
+    // (data from C++, an as_numpy view) need invalidate_aggregates().
+    void set_track_aggregates(bool enabled);
+    bool get_track_aggregates() const;
+    void invalidate_aggregates();   // Also marks the range-sum index stale
+
+    // Sum of elements [lo, hi), clamped to the list like a Python slice.
+    // set_range_sum_index picks "none", "prefix" (mostly static data) or
+    // "fenwick" (frequent set/scatter); add, set, clear and the other
+    // mutators keep the index in sync. Other names throw std::invalid_argument.
+    // Float lists accept every kind but always sum the slice, since
+    // differences of running float totals lose the small terms.
+    SumType<T> range_sum(int lo, int hi) const;
+    void set_range_sum_index(const std::string& kind);
+    std::string get_range_sum_index() const;
+
+    // Minimum / maximum of [lo, hi), clamped like range_sum; 0 for an empty
+    // range. The arg variants return the leftmost position, or -1 if empty.
+    // set_range_extreme_index picks "none", "sparse" (mostly static data) or
+    // "segment" (frequent set/scatter), kept in sync like the sum index;
+    // other names throw std::invalid_argument.
+    T range_min(int lo, int hi) const;
+    T range_max(int lo, int hi) const;
+    int range_argmin(int lo, int hi) const;
+    int range_argmax(int lo, int hi) const;
+    void set_range_extreme_index(const std::string& kind);
+    std::string get_range_extreme_index() const;
+
+    // Minimum / maximum of every full window of the given width, in one
+    // pass with a monotone deque (size() - window + 1 results)
+    BasicFastList sliding_min(int window) const;
+    BasicFastList sliding_max(int window) const;
+
+    // Selection without a full sort: the k largest (descending), the k
+    // smallest (ascending), the element of rank n (0 if out of range) and
+    // linearly interpolated quantiles for each q in [0, 1]
+    BasicFastList topk(int k) const;
+    BasicFastList partial_sorted(int k) const;
+    T nth(int n) const;
+    std::vector<double> quantiles(const std::vector<double>& qs) const;
+
+    // Permutation that sorts the list (sorted() == gather_list(argsort(...))).
+    // stable keeps equal elements in their original order.
+    BasicFastList<int> argsort(bool stable) const;
+    // Sort this list as keys and apply the same permutation to values, a
+    // list of any element type (equal keys keep their order; throws
+    // std::invalid_argument on a length mismatch)
+    template <typename V>
+    void sort_by_key(BasicFastList<V>& values);
+
+private:
+    template <typename> friend class BasicFastList;
+    void grow_for(size_t extra);
+    void check_storage(size_t needed) const;
+    void note_appended(size_t begin);
+    void note_overwrite(size_t index, T value);
+    void range_index_append(size_t begin);
+    void range_index_overwrite(size_t index, T value);
+    void range_index_truncate();
+    void ensure_range_index() const;
+    bool range_indexed() const;
+    WrappingSum<T> range_prefix(size_t count) const;
+    bool observed() const;
+    void write_element(size_t index, T value);
+    uint32_t pick_extreme(uint32_t a, uint32_t b, int which) const;
+    int range_extreme(int lo, int hi, int which) const;
+    void extreme_index_append(size_t begin);
+    void extreme_index_written(size_t index);
+    void ensure_extreme_index() const;
+    BasicFastList sliding_extreme(int window, int which) const;
+    bool resolve_index(int& index) const;
+    void gather_into(const int* indices, size_t count, T* out) const;
+    void scatter_from(const int* indices, const T* values, size_t count);
+    // Number of live views; copying a list does not copy its views
+    struct ViewCount {
+        int count = 0;
+        ViewCount() = default;
+        ViewCount(const ViewCount&) {}
+        ViewCount& operator=(const ViewCount&) { return *this; }
+    };
+    ViewCount views;
+    double growth_factor;
+    BoundsPolicy bounds_policy;
+    T fill_value;
+    bool track_aggregates;
+    mutable bool sum_valid;
+    mutable bool running_extremes_valid;
+    mutable SumType<T> tracked_sum;
+    mutable T tracked_min;
+    mutable T tracked_max;
+    RangeSumIndex range_index;
+    mutable std::vector<WrappingSum<T>> range_tree;   // size() + 1 prefix sums or Fenwick nodes
+    mutable size_t range_valid;                        // Elements whose range_tree entries are current
+    RangeExtremeIndex extreme_index;
+    mutable bool range_extreme_valid;
+    mutable std::vector<std::vector<uint32_t>> sparse_levels[2];   // [min, max][level][start]
+    mutable std::vector<uint32_t> segment_nodes[2];                 // [min, max], 1-based heap layout
+    mutable size_t segment_leaves;
+    mutable size_t extreme_size;                                    // Elements the tables were built for
 };
 
-std::vector<int> fast_sort(const std::vector<int>& input);
-std::vector<int> fast_reverse(const std::vector<int>& input);
-int64_t fast_sum(const std::vector<int>& input);
-int fast_max(const std::vector<int>& input);
-int fast_min(const std::vector<int>& input);
+// Each alias below is bound as its own class in fast_list.cp, with its own
+// copy of the method list: a new method needs a METHOD line in all five
+// FastList blocks (and a FIELD line in all five FastStats blocks)
+using FastList = BasicFastList<int>;
+using FastListI64 = BasicFastList<int64_t>;
+using FastListF32 = BasicFastList<float>;
+using FastListF64 = BasicFastList<double>;
+using FastListU8 = BasicFastList<uint8_t>;
+
+using FastStats = BasicFastStats<int>;
+using FastStatsI64 = BasicFastStats<int64_t>;
+using FastStatsF32 = BasicFastStats<float>;
+using FastStatsF64 = BasicFastStats<double>;
+using FastStatsU8 = BasicFastStats<uint8_t>;
+
+// Kernels over any contiguous buffer of the element types above
+// (NumPy arrays, FastList::data, ...)
+template <typename T> void fast_sort_n(T* data, size_t count);
+template <typename T> void fast_reverse_n(T* data, size_t count);
+template <typename T> void fast_sort_copy_n(const T* input, T* output, size_t count);
+template <typename T> void fast_reverse_copy_n(const T* input, T* output, size_t count);
+template <typename T> SumType<T> fast_sum_n(const T* data, size_t count);
+template <typename T> SumType<T> fast_sum_checked_n(const T* data, size_t count);  // Throws std::overflow_error
+template <typename T> T fast_max_n(const T* data, size_t count);
+template <typename T> T fast_min_n(const T* data, size_t count);
+template <typename T> BasicFastStats<T> fast_stats_n(const T* data, size_t count);
+template <typename T> void fast_topk_n(const T* data, size_t count, size_t k, T* out);
+template <typename T> void fast_partial_sort_n(const T* data, size_t count, size_t k, T* out);
+template <typename T> T fast_nth_n(const T* data, size_t count, size_t n);
+template <typename T> void fast_quantiles_n(const T* data, size_t count, const double* qs, size_t q, double* out);
+template <typename T> void fast_argsort_n(const T* data, size_t count, bool stable, int* out);
+template <typename K, typename V> void fast_sort_by_key_n(K* keys, V* values, size_t count);  // Stable, sorts both
+
+// Write into a caller-owned FastList of any element type, reusing its storage
+void fast_sort_into(const FastList& input, FastList& output);
+void fast_sort_into(const FastListI64& input, FastListI64& output);
+void fast_sort_into(const FastListF32& input, FastListF32& output);
+void fast_sort_into(const FastListF64& input, FastListF64& output);
+void fast_sort_into(const FastListU8& input, FastListU8& output);
+void fast_reverse_into(const FastList& input, FastList& output);
+void fast_reverse_into(const FastListI64& input, FastListI64& output);
+void fast_reverse_into(const FastListF32& input, FastListF32& output);
+void fast_reverse_into(const FastListF64& input, FastListF64& output);
+void fast_reverse_into(const FastListU8& input, FastListU8& output);
+
+// Functions over Python lists (std::vector), one overload per element type.
+// From Python the bindings try the overloads in the order fast_list.cp lists
+// them (int32, int64, float64, float32, uint8) and take the first that
+// converts every element; fast_list_dtype and the *_buffer entry points
+// select a type explicitly.
+#define FAST_LIST_DECLARE_VECTOR_FUNCTIONS(T)                                                \
+    std::vector<T> fast_sort(const std::vector<T>& input);                                  \
+    std::vector<T> fast_reverse(const std::vector<T>& input);                               \
+    SumType<T> fast_sum(const std::vector<T>& input);                                       \
+    SumType<T> fast_sum_checked(const std::vector<T>& input);                               \
+    T fast_max(const std::vector<T>& input);                                                \
+    T fast_min(const std::vector<T>& input);                                                \
+    BasicFastStats<T> fast_stats(const std::vector<T>& input);                              \
+    std::vector<T> fast_topk(const std::vector<T>& input, int k);         /* k largest, descending */ \
+    std::vector<T> fast_partial_sort(const std::vector<T>& input, int k); /* k smallest, ascending */ \
+    T fast_nth(const std::vector<T>& input, int n);                                         \
+    std::vector<double> fast_quantiles(const std::vector<T>& input, const std::vector<double>& qs); \
+    std::vector<int> fast_argsort(const std::vector<T>& input, bool stable);                \
+    std::vector<T> fast_sort_by_key(const std::vector<T>& keys, const std::vector<T>& values);  /* values reordered */
+
+FAST_LIST_DECLARE_VECTOR_FUNCTIONS(int)
+FAST_LIST_DECLARE_VECTOR_FUNCTIONS(int64_t)
+FAST_LIST_DECLARE_VECTOR_FUNCTIONS(double)
+FAST_LIST_DECLARE_VECTOR_FUNCTIONS(float)
+FAST_LIST_DECLARE_VECTOR_FUNCTIONS(uint8_t)
+
+#undef FAST_LIST_DECLARE_VECTOR_FUNCTIONS
+
+#ifdef FAST_LIST_PYTHON
+// The kernels over any object exporting a 1-D contiguous buffer (NumPy
+// arrays, bytearray, memoryview, array.array), without a conversion copy.
+// The element type follows the buffer format: int32, int64, float32,
+// float64 or uint8, else TypeError; other shapes raise ValueError. sort and
+// reverse write to out, which must be writable (else BufferError) and either
+// input itself (in place) or a buffer of the same length not overlapping it.
+void fast_sort_buffer(pybind11::buffer input, pybind11::buffer out);
+void fast_reverse_buffer(pybind11::buffer input, pybind11::buffer out);
+pybind11::object fast_sum_buffer(pybind11::buffer input);
+pybind11::object fast_min_buffer(pybind11::buffer input);
+pybind11::object fast_max_buffer(pybind11::buffer input);
+pybind11::object fast_stats_buffer(pybind11::buffer input);
+#endif
+
+// Worker threads used by sorts of large inputs (default: hardware threads).
+// Results are identical for every thread count. The pool serves one sort at a
+// time: a sort that starts while another thread's sort holds it runs serially
+// on its calling thread rather than waiting for the pool. Setting or reading
+// the count never waits either; a new count applies from the next sort.
+void fast_set_num_threads(int threads);
+int fast_get_num_threads();
 
 }
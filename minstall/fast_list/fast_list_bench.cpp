@@ -0,0 +1,176 @@
+/**
+ * FAST LIST SORT BENCHMARK
+ *
+ * Times fast_sort_n against std::sort (and pdqsort, when pdqsort.h from
+ * github.com/orlp/pdqsort is on the include path) on random keys of every
+ * element type, and finds the sizes where the radix and parallel paths start
+ * to win, which is where the thresholds in fast_list.cpp come from.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread fast_list_bench.cpp -o fast_list_bench
+ * Usage:  fast_list_bench sizes [max_n]   fast_sort_n vs comparison sorts for
+ *                                         n = 10^3 .. max_n (default 10^8;
+ *                                         10^9 needs ~20 GB for int64/double)
+ *         fast_list_bench crossover       smallest sizes where the serial radix
+ *                                         sort beats std::sort and the pooled
+ *                                         radix sort beats the serial one
+ *                                         (needs more than one hardware thread)
+ *
+ * Times are the median of several runs, in nanoseconds per element.
+ */
+
+#include "fast_list.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#if __has_include("pdqsort.h")
+#include "pdqsort.h"
+#define FAST_LIST_BENCH_PDQSORT 1
+#endif
+
+namespace includecpp {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T>
+std::vector<T> random_keys(size_t n, uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<T> data(n);
+    for (auto& value : data) {
+        if constexpr (std::is_integral<T>::value) {
+            value = static_cast<T>(random());
+        } else {
+            value = static_cast<T>(std::ldexp(static_cast<double>(static_cast<int64_t>(random())), -40));
+        }
+    }
+    return data;
+}
+
+// Median time per element of sort applied to fresh copies of input. Small
+// inputs are sorted as a batch of copies so every sample spans a few ms.
+template <typename T, typename Sort>
+double ns_per_element(const std::vector<T>& input, const Sort& sort) {
+    const size_t n = input.size();
+    const size_t batch = std::max<size_t>(1, (size_t(1) << 18) / std::max<size_t>(n, 1));
+    const int samples = n >= 100000000 ? 3 : 7;
+    std::vector<T> work(n * batch);
+    std::vector<double> times;
+    for (int s = 0; s < samples; s++) {
+        for (size_t b = 0; b < batch; b++) std::copy(input.begin(), input.end(), work.begin() + b * n);
+        const Clock::time_point start = Clock::now();
+        for (size_t b = 0; b < batch; b++) sort(work.data() + b * n, n);
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        times.push_back(elapsed.count() / static_cast<double>(n * batch));
+    }
+    std::nth_element(times.begin(), times.begin() + samples / 2, times.end());
+    return times[samples / 2];
+}
+
+template <typename T>
+void std_sort(T* data, size_t count) {
+    std::sort(data, data + count, KeyLess<T>());
+}
+
+// sort_dispatch's serial radix path without its size threshold
+template <typename T>
+void serial_radix_sort(T* data, size_t count) {
+    using Key = typename RadixKey<T>::Key;
+    std::unique_ptr<Key[]> buffer;
+    Key* keys;
+    if constexpr (std::is_integral<T>::value) {
+        keys = reinterpret_cast<Key*>(data);
+    } else {
+        buffer.reset(new Key[count]);
+        keys = buffer.get();
+    }
+    for (size_t i = 0; i < count; i++) keys[i] = RadixKey<T>::encode(data[i]);
+    radix_sort_keys(keys, count);
+    for (size_t i = 0; i < count; i++) data[i] = RadixKey<T>::decode(keys[i]);
+}
+
+template <typename T>
+void report_sizes(const char* name, size_t max_n) {
+    const int threads = fast_get_num_threads();
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        const std::vector<T> input = random_keys<T>(n, n);
+        const double reference = ns_per_element(input, std_sort<T>);
+        std::printf("%-4s %11zu  std::sort %7.2f", name, n, reference);
+#ifdef FAST_LIST_BENCH_PDQSORT
+        const double pdq = ns_per_element(input, [](T* data, size_t count) {
+            pdqsort(data, data + count, KeyLess<T>());
+        });
+        std::printf("  pdqsort %7.2f", pdq);
+#endif
+        fast_set_num_threads(1);
+        const double serial = ns_per_element(input, fast_sort_n<T>);
+        fast_set_num_threads(threads);
+        const double pooled = ns_per_element(input, fast_sort_n<T>);
+        std::printf("  fast_sort 1 thread %7.2f (%5.1fx)  %d threads %7.2f (%5.1fx)\n",
+                    serial, reference / serial, threads, pooled, reference / pooled);
+        std::fflush(stdout);
+    }
+}
+
+// Smallest size on a geometric grid from which faster stays ahead of slower
+// for the rest of the grid
+template <typename T, typename Slower, typename Faster>
+size_t crossover(size_t lo, size_t hi, const Slower& slower, const Faster& faster) {
+    size_t found = 0;
+    for (size_t n = lo; n <= hi; n = n + n / 4 + 1) {
+        const std::vector<T> input = random_keys<T>(n, n);
+        if (ns_per_element(input, faster) < ns_per_element(input, slower)) {
+            if (!found) found = n;
+        } else {
+            found = 0;
+        }
+    }
+    return found;
+}
+
+template <typename T>
+void report_crossover(const char* name, SortThreadPool& pool) {
+    const size_t radix = crossover<T>(16, 32768, std_sort<T>, serial_radix_sort<T>);
+    using Key = typename RadixKey<T>::Key;
+    std::printf("%-4s radix over std::sort from %6zu (RADIX_SORT_THRESHOLD: %zu)", name, radix,
+                radix_sort_threshold<Key>());
+    if (pool.size() > 1) {
+        auto serial_keys = [](Key* keys, size_t count) { radix_sort_keys(keys, count); };
+        auto pooled_keys = [&pool](Key* keys, size_t count) { parallel_radix_sort_keys(keys, count, pool); };
+        const size_t parallel = crossover<Key>(size_t(1) << 13, size_t(1) << 21, serial_keys, pooled_keys);
+        std::printf("   %d-worker radix over serial from %8zu (PARALLEL_SORT_THRESHOLD: %zu)", pool.size(),
+                    parallel, PARALLEL_SORT_THRESHOLD);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+}  // namespace
+}  // namespace includecpp
+
+int main(int argc, char** argv) {
+    using namespace includecpp;
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "sizes") {
+        const size_t max_n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000000;
+        report_sizes<int>("i32", max_n);
+        report_sizes<int64_t>("i64", max_n);
+        report_sizes<float>("f32", max_n);
+        report_sizes<double>("f64", max_n);
+        report_sizes<uint8_t>("u8", max_n);
+        return 0;
+    }
+    if (mode == "crossover") {
+        SortThreadPool pool(fast_get_num_threads());
+        report_crossover<int>("i32", pool);
+        report_crossover<int64_t>("i64", pool);
+        report_crossover<float>("f32", pool);
+        report_crossover<double>("f64", pool);
+        report_crossover<uint8_t>("u8", pool);
+        return 0;
+    }
+    std::fprintf(stderr, "usage: %s sizes [max_n] | crossover\n", argv[0]);
+    return 2;
+}
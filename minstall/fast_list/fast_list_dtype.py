@@ -0,0 +1,111 @@
+"""
+FAST LIST DTYPE FACADE
+======================
+Picks the FastList instantiation for a NumPy dtype, so callers work with
+int32, int64, float32, float64 and uint8 columns through one interface.
+
+    from fast_list_dtype import new_list, from_numpy, as_numpy, sort_array
+
+    prices = from_numpy(np.array([3.5, 1.25, 2.0]))   # FastListF64
+    prices.sort()
+    view = as_numpy(prices)                          # zero-copy float64 view
+    sort_array(view, out=view)                       # kernels straight on an array
+    sum_array(bytearray(b"abc"))                     # ... or on any 1-D buffer
+"""
+
+import numpy as np
+from includecpp import fast_list
+
+LIST_TYPES = {
+    np.dtype(np.int32): fast_list.FastList,
+    np.dtype(np.int64): fast_list.FastListI64,
+    np.dtype(np.float32): fast_list.FastListF32,
+    np.dtype(np.float64): fast_list.FastListF64,
+    np.dtype(np.uint8): fast_list.FastListU8,
+}
+
+DTYPES = {list_type: dtype for dtype, list_type in LIST_TYPES.items()}
+
+
+def new_list(dtype=np.int32):
+    """Empty FastList holding elements of dtype"""
+    dtype = np.dtype(dtype)
+    if dtype not in LIST_TYPES:
+        raise TypeError(f"FastList has no instantiation for {dtype}")
+    return LIST_TYPES[dtype]()
+
+
+def dtype_of(lst):
+    """NumPy dtype of a FastList's elements"""
+    return DTYPES[type(lst)]
+
+
+def from_numpy(array):
+    """Copy a 1-D array into a new FastList of the matching type (one memcpy)"""
+    array = np.ascontiguousarray(array).ravel()
+    lst = new_list(array.dtype)
+    lst.extend_buffer(array)
+    return lst
+
+
+def as_numpy(lst):
+    """Zero-copy view of a FastList.
+
+    The view keeps lst alive, so as_numpy(lst.sorted()) is safe, and pins its
+    storage: while any view is alive, growing lst past capacity() raises
+    RuntimeError instead of moving the elements. Reserve first to append
+    through a view's lifetime, or drop the views before growing. Assigning
+    lst.data replaces the storage unchecked; do not do it while views live.
+    """
+    return lst.view()
+
+
+def sort_into(source, out):
+    """Sorted copy of source written into out, reusing out's storage"""
+    fast_list.fast_sort_into(source, out)
+
+
+def reverse_into(source, out):
+    """Reversed copy of source written into out, reusing out's storage"""
+    fast_list.fast_reverse_into(source, out)
+
+
+def _into(kernel, array, out):
+    if out is None:
+        out = np.empty_like(np.asarray(array))
+    elif memoryview(out).readonly:
+        raise ValueError(f"{kernel.__name__}: out is read-only")
+    kernel(array, out)
+    return out
+
+
+def sort_array(array, out=None):
+    """Sorted copy of a 1-D buffer (NumPy array, bytearray, memoryview,
+    array.array), without converting it to a list. out=array sorts in place;
+    returns out (a new NumPy array by default)."""
+    return _into(fast_list.fast_sort_buffer, array, out)
+
+
+def reverse_array(array, out=None):
+    """Reversed copy of a 1-D buffer; out=array reverses in place"""
+    return _into(fast_list.fast_reverse_buffer, array, out)
+
+
+def sum_array(array):
+    """Sum of a 1-D buffer (int64 for integer elements, wrapping on overflow)"""
+    return fast_list.fast_sum_buffer(array)
+
+
+def min_array(array):
+    """Smallest element of a 1-D buffer (0 if empty)"""
+    return fast_list.fast_min_buffer(array)
+
+
+def max_array(array):
+    """Largest element of a 1-D buffer (0 if empty)"""
+    return fast_list.fast_max_buffer(array)
+
+
+def stats_array(array):
+    """fast_stats of a 1-D buffer in one pass"""
+    return fast_list.fast_stats_buffer(array)
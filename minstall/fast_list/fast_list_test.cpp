@@ -0,0 +1,841 @@
+/**
+ * FAST LIST BEHAVIOUR TESTS
+ *
+ * Checks the incremental index structures and mutation rules of FastList
+ * against naive recomputation.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread fast_list_test.cpp fast_list.cpp -o fast_list_test
+ * Usage:  fast_list_test   (exit status 0 when every check passes)
+ */
+
+#include "fast_list.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+template <typename T>
+T naive_min(const std::vector<T>& data, int lo, int hi) {
+    T best = data[lo];
+    for (int i = lo + 1; i < hi; i++) best = std::min(best, data[i]);
+    return best;
+}
+
+template <typename T>
+T naive_max(const std::vector<T>& data, int lo, int hi) {
+    T best = data[lo];
+    for (int i = lo + 1; i < hi; i++) best = std::max(best, data[i]);
+    return best;
+}
+
+template <typename T>
+int64_t naive_sum(const std::vector<T>& data, int lo, int hi) {
+    int64_t sum = 0;
+    for (int i = lo; i < hi; i++) sum += data[i];
+    return sum;
+}
+
+// Every range of a list against the naive answer
+void check_extremes(includecpp::FastList& list) {
+    const int n = list.size();
+    for (int lo = 0; lo < n; lo += 7) {
+        for (int hi = lo + 1; hi <= n; hi += 5) {
+            CHECK(list.range_min(lo, hi) == naive_min(list.data, lo, hi));
+            CHECK(list.range_max(lo, hi) == naive_max(list.data, lo, hi));
+        }
+    }
+}
+
+// Appends after a query must extend the sparse table and segment tree
+void test_extreme_index_appends() {
+    for (const char* kind : {"sparse", "segment"}) {
+        includecpp::FastList list;
+        list.set_range_extreme_index(kind);
+        CHECK(list.get_range_extreme_index() == kind);
+        std::mt19937 random(7);
+        for (int i = 0; i < 50; i++) list.add(static_cast<int>(random() % 1000));
+        check_extremes(list);
+        for (int i = 0; i < 150; i++) list.add(static_cast<int>(random() % 1000) - 500);
+        list.extend({-1000, 2000});
+        check_extremes(list);
+        CHECK(list.range_argmin(0, list.size()) == list.size() - 2);
+        CHECK(list.range_argmax(0, list.size()) == list.size() - 1);
+
+        // Point updates, and a resize behind the class's back
+        list.set(3, -5000);
+        CHECK(list.range_min(0, 10) == -5000);
+        list.data.resize(20);
+        list.add(-6000);
+        check_extremes(list);
+    }
+}
+
+// sliding_min / sliding_max against a brute-force scan of every window,
+// with heavy duplicates so ties must not evict a still-live extreme
+void test_sliding_extremes() {
+    std::mt19937 random(73);
+    includecpp::FastListF64 list;
+    for (int i = 0; i < 40; i++) list.add(static_cast<double>(random() % 4) - 1.5);
+    const int n = list.size();
+    for (int window : {1, 2, 3, 7, n - 1, n}) {
+        includecpp::FastListF64 lows = list.sliding_min(window);
+        includecpp::FastListF64 highs = list.sliding_max(window);
+        CHECK(lows.size() == n - window + 1 && highs.size() == n - window + 1);
+        for (int i = 0; i + window <= n && i < lows.size(); i++) {
+            CHECK(lows.get(i) == naive_min(list.data, i, i + window));
+            CHECK(highs.get(i) == naive_max(list.data, i, i + window));
+        }
+    }
+    CHECK(list.sliding_min(1).data == list.data);
+    for (int window : {n + 1, 1000, 0, -2}) {
+        CHECK(list.sliding_min(window).size() == 0 && list.sliding_max(window).size() == 0);
+    }
+
+    includecpp::FastList flat;
+    flat.extend({5, 5, 5, 5});
+    CHECK(flat.sliding_max(2).data == std::vector<int>({5, 5, 5}));
+    CHECK(flat.sliding_min(4).data == std::vector<int>({5}));
+    CHECK(includecpp::FastList().sliding_min(1).size() == 0);
+}
+
+// Fenwick and prefix sums stay exact across set, scatter and appends
+void test_range_sum_index_updates() {
+    for (const char* kind : {"prefix", "fenwick"}) {
+        includecpp::FastListI64 list;
+        list.set_range_sum_index(kind);
+        std::mt19937 random(11);
+        for (int i = 0; i < 300; i++) list.add(static_cast<int64_t>(random() % 100000));
+        CHECK(list.range_sum(0, 300) == naive_sum(list.data, 0, 300));
+        for (int round = 0; round < 200; round++) {
+            list.set(static_cast<int>(random() % 300), static_cast<int64_t>(random() % 100000) - 50000);
+            if (round % 50 == 0) list.scatter({1, 2, 3}, {10, 20, 30});
+            int lo = static_cast<int>(random() % 300);
+            int hi = lo + static_cast<int>(random() % (301 - lo));
+            CHECK(list.range_sum(lo, hi) == naive_sum(list.data, lo, hi));
+        }
+        // Slices clamp like Python, and appends after a query are indexed
+        CHECK(list.range_sum(-10, 1000) == naive_sum(list.data, 0, 300));
+        list.add(5);
+        CHECK(list.range_sum(299, 301) == naive_sum(list.data, 299, 301));
+        list.data.resize(10);
+        list.add(1);
+        CHECK(list.range_sum(0, 11) == naive_sum(list.data, 0, 11));
+    }
+
+    // Float lists sum the slice itself, so small terms next to a huge one survive
+    includecpp::FastListF64 floats;
+    floats.set_range_sum_index("fenwick");
+    floats.add(1e17);
+    for (int i = 0; i < 10; i++) floats.add(1.0);
+    CHECK(floats.range_sum(1, 11) == 10.0);
+
+    bool threw = false;
+    try {
+        floats.set_range_sum_index("fenwik");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw && floats.get_range_sum_index() == "fenwick");
+}
+
+// Every slice of an int32 list against the naive sum
+void check_int32_sums(includecpp::FastList& list) {
+    const int n = list.size();
+    for (int lo = 0; lo <= n; lo += 3) {
+        for (int hi = lo; hi <= n; hi += 7) {
+            CHECK(list.range_sum(lo, hi) == naive_sum(list.data, lo, hi));
+        }
+        CHECK(list.range_sum(lo, n) == naive_sum(list.data, lo, n));
+    }
+}
+
+// The int32 prefix scan (AVX2 where available) and the Fenwick tree stay
+// exact across set, scatter, extend and resize, for lengths off the 8-lane
+// grid and sums beyond int32
+void test_int32_range_sums() {
+    for (const char* kind : {"none", "prefix", "fenwick"}) {
+        includecpp::FastList list;
+        list.set_range_sum_index(kind);
+        std::mt19937 random(72);
+        for (int i = 0; i < 203; i++) list.add(static_cast<int>(random() % 2000001) - 1000000);
+        list.set(0, std::numeric_limits<int>::max());
+        list.set(1, std::numeric_limits<int>::max());
+        list.set(100, std::numeric_limits<int>::min());
+        check_int32_sums(list);
+        for (int round = 0; round < 50; round++) {
+            list.set(static_cast<int>(random() % 203), static_cast<int>(random() % 1000) - 500);
+        }
+        list.scatter({5, 6, 202}, {std::numeric_limits<int>::max(), -7, 8});
+        check_int32_sums(list);
+        list.extend({1, 2, 3, 4, 5});
+        check_int32_sums(list);
+        list.resize(229, std::numeric_limits<int>::max());
+        check_int32_sums(list);
+        list.resize(77, 0);
+        check_int32_sums(list);
+        list.add(-9);
+        CHECK(list.range_sum(70, 78) == naive_sum(list.data, 70, 78));
+    }
+}
+
+// Tracked aggregates rescan after writes that may have moved an extreme
+void test_aggregate_invalidation() {
+    includecpp::FastList list;
+    list.set_track_aggregates(true);
+    list.extend({5, 1, 9, 3});
+    CHECK(list.minimum() == 1 && list.maximum() == 9 && list.sum() == 18);
+    list.set(1, 7);     // Overwrites the minimum
+    CHECK(list.minimum() == 3 && list.sum() == 24);
+    list.add(-2);
+    CHECK(list.minimum() == -2 && list.sum() == 22);
+    list.data[2] = 100;     // Bypasses the class
+    list.invalidate_aggregates();
+    CHECK(list.maximum() == 100 && list.sum() == 113);
+    list.clear();
+    CHECK(list.sum() == 0);
+}
+
+// Appending a list to itself reads the elements before the storage moves
+void test_self_append() {
+    includecpp::FastList list;
+    list.extend({1, 2, 3});
+    list.extend_list(list);
+    list.extend_list(list);
+    CHECK(list.size() == 12);
+    for (int i = 0; i < 12; i++) CHECK(list.get(i) == i % 3 + 1);
+}
+
+// extend_range follows Python's range() (negative steps, empty ranges,
+// spans wider than the element type) and refuses more than INT_MAX elements
+void test_extend_range() {
+    includecpp::FastList ints;
+    ints.extend_range(0, 10, 3);
+    ints.extend_range(10, 0, -3);
+    CHECK(ints.data == std::vector<int>({0, 3, 6, 9, 10, 7, 4, 1}));
+    ints.extend_range(5, 5, 1);
+    ints.extend_range(5, 0, 1);
+    ints.extend_range(0, 5, -1);
+    ints.extend_range(0, 5, 0);
+    CHECK(ints.size() == 8);
+
+    const int64_t lo = std::numeric_limits<int64_t>::min();
+    const int64_t hi = std::numeric_limits<int64_t>::max();
+    includecpp::FastListI64 wide;
+    wide.extend_range(lo, hi, hi);
+    CHECK(wide.data == std::vector<int64_t>({lo, -1, hi - 1}));
+    wide.extend_range(hi, lo, lo + 1);
+    CHECK(wide.size() == 6 && wide.get(5) == lo + 1);
+    for (int64_t step : {int64_t(1), int64_t(-1), int64_t(2)}) {
+        bool threw = false;
+        try {
+            if (step > 0) wide.extend_range(lo, hi, step);
+            else wide.extend_range(hi, lo, step);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        CHECK(threw && wide.size() == 6);
+    }
+
+    includecpp::FastListF64 floats;
+    floats.extend_range(0.0, 1.0, 0.25);
+    floats.extend_range(1.0, 0.0, -0.5);
+    floats.extend_range(0.0, 1.0, -0.5);
+    CHECK(floats.data == std::vector<double>({0.0, 0.25, 0.5, 0.75, 1.0, 0.5}));
+    bool threw = false;
+    try {
+        floats.extend_range(0.0, 1e10, 1.0);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw && floats.size() == 6);
+
+    includecpp::FastListU8 bytes;
+    bytes.extend_range(250, 255, 2);
+    CHECK(bytes.data == std::vector<uint8_t>({250, 252, 254}));
+}
+
+// reserve, resize and the growth factor decide the capacity
+void test_capacity_controls() {
+    includecpp::FastList list;
+    list.reserve(10);
+    list.reserve(-5);
+    CHECK(list.capacity() >= 10 && list.size() == 0);
+    list.resize(10, 4);
+    CHECK(list.size() == 10 && list.sum() == 40);
+    list.resize(3, 9);
+    CHECK(list.data == std::vector<int>({4, 4, 4}));
+    list.resize(-1, 0);
+    CHECK(list.size() == 0);
+
+    includecpp::FastList grown;
+    grown.reserve(10);
+    grown.resize(10, 1);
+    grown.set_growth_factor(3.0);
+    grown.add(2);
+    CHECK(grown.capacity() == 30);
+    grown.set_growth_factor(0.5);
+    grown.resize(30, 0);
+    grown.add(3);
+    CHECK(grown.capacity() == 31 && grown.get(30) == 3);
+
+    for (double factor : {std::nan(""), 64.5}) {
+        bool threw = false;
+        try {
+            grown.set_growth_factor(factor);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw && grown.get_growth_factor() == 0.5);
+    }
+}
+
+// A live view pins the storage: growth past capacity() throws, growth
+// within it and shrinking still work, and copies start unpinned
+void test_view_pinning() {
+    includecpp::FastList list;
+    list.reserve(4);
+    list.extend({1, 2});
+    const int* address = list.acquire_view();
+    CHECK(list.view_count() == 1);
+    list.add(3);
+    list.add(4);
+    CHECK(address[3] == 4);
+    for (auto grow : {0, 1, 2, 3}) {
+        bool threw = false;
+        try {
+            if (grow == 0) list.add(5);
+            if (grow == 1) list.extend({5, 6});
+            if (grow == 2) list.resize(9, 0);
+            if (grow == 3) list.reserve(100);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+    CHECK(list.size() == 4 && list.data.data() == address);
+    includecpp::FastList larger;
+    larger.extend({9, 8, 7, 6, 5});
+    bool threw = false;
+    try {
+        includecpp::fast_sort_into(larger, list);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    list.resize(2, 0);
+    list.add(7);
+    CHECK(list.to_list() == std::vector<int>({1, 2, 7}));
+
+    includecpp::FastList copy = list;
+    CHECK(copy.view_count() == 0);
+    copy.extend({1, 2, 3, 4, 5});
+
+    list.release_view();
+    list.extend({5, 6, 7});
+    CHECK(list.size() == 6);
+    threw = false;
+    try {
+        list.release_view();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void test_bounds_policies() {
+    includecpp::FastList list;
+    list.extend({10, 20, 30});
+    CHECK(list.get_bounds_policy() == "fill");
+    list.set_fill_value(-1);
+    CHECK(list.gather({0, 5, -1}).data == std::vector<int>({10, -1, -1}));
+    list.scatter({7}, {99});    // Skipped
+    CHECK(list.data == std::vector<int>({10, 20, 30}));
+
+    list.set_bounds_policy("clip");
+    CHECK(list.gather({-4, 1, 8}).data == std::vector<int>({10, 20, 30}));
+    list.scatter({8}, {33});
+    CHECK(list.get(2) == 33);
+
+    list.set_bounds_policy("raise");
+    bool threw = false;
+    try {
+        list.scatter({0, 3}, {1, 2});
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(list.get(0) == 10);   // Validated before any write
+
+    threw = false;
+    try {
+        list.set_bounds_policy("wrap");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw && list.get_bounds_policy() == "raise");
+}
+
+void test_sort_by_key() {
+    includecpp::FastList keys;
+    keys.extend({3, 1, 2, 1});
+    includecpp::FastListF64 values;
+    values.extend({0.3, 0.1, 0.2, 0.15});
+    keys.sort_by_key(values);
+    CHECK(keys.data == std::vector<int>({1, 1, 2, 3}));
+    CHECK(values.data == std::vector<double>({0.1, 0.15, 0.2, 0.3}));
+}
+
+
+// Integer sums wrap through uint64_t on every kernel (scalar, AVX2, AVX-512)
+// and float sums agree with a long-double reference
+template <typename T>
+void check_sums(std::mt19937& random) {
+    for (size_t n : {0, 1, 7, 15, 16, 17, 31, 33, 64, 1000, 100003}) {
+        std::vector<T> data(n);
+        const int offset = std::is_signed<T>::value ? 1000 : 0;
+        for (auto& value : data) value = static_cast<T>(static_cast<int>(random() % 2001) - offset);
+        if (std::is_integral<T>::value) {
+            uint64_t expected = 0;
+            for (T value : data) expected += static_cast<uint64_t>(static_cast<int64_t>(value));
+            CHECK(static_cast<uint64_t>(includecpp::fast_sum_n(data.data(), n)) == expected);
+        } else {
+            long double expected = 0;
+            for (T value : data) expected += value;
+            long double sum = includecpp::fast_sum_n(data.data(), n);
+            CHECK(std::abs(sum - expected) < 1e-6L * (n + 1));
+        }
+    }
+}
+
+void test_simd_sums() {
+    std::mt19937 random(3);
+    check_sums<int>(random);
+    check_sums<int64_t>(random);
+    check_sums<float>(random);
+    check_sums<double>(random);
+    check_sums<uint8_t>(random);
+
+    std::vector<int> extremes(100003, std::numeric_limits<int>::max());
+    CHECK(includecpp::fast_sum(extremes) == int64_t(100003) * std::numeric_limits<int>::max());
+    std::fill(extremes.begin(), extremes.end(), std::numeric_limits<int>::min());
+    CHECK(includecpp::fast_sum(extremes) == int64_t(100003) * std::numeric_limits<int>::min());
+
+    std::vector<int64_t> wrapping = {std::numeric_limits<int64_t>::max(), 1};
+    CHECK(includecpp::fast_sum_n(wrapping.data(), wrapping.size()) == std::numeric_limits<int64_t>::min());
+    bool threw = false;
+    try {
+        includecpp::fast_sum_checked_n(wrapping.data(), wrapping.size());
+    } catch (const std::overflow_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+
+// fast_stats_n against a two-pass reference: block sizes straddle the
+// 8-lane sweep, duplicated extremes must report their first position
+template <typename T>
+void check_stats(std::mt19937& random, int offset) {
+    for (size_t n : {1, 2, 7, 8, 9, 63, 64, 65, 1000, 100001}) {
+        std::vector<T> data(n);
+        for (auto& value : data) value = static_cast<T>(static_cast<int>(random() % 200) - offset);
+        data[n / 2] = data[n - 1];
+        includecpp::BasicFastStats<T> stats = includecpp::fast_stats_n(data.data(), n);
+        size_t argmin = std::min_element(data.begin(), data.end()) - data.begin();
+        size_t argmax = std::max_element(data.begin(), data.end()) - data.begin();
+        long double sum = 0;
+        for (T value : data) sum += value;
+        long double mean = sum / n, m2 = 0;
+        for (T value : data) m2 += (value - mean) * (value - mean);
+        CHECK(stats.count == static_cast<int64_t>(n));
+        CHECK(std::abs(static_cast<long double>(stats.sum) - sum) < 1e-3L);
+        CHECK(stats.min == data[argmin] && stats.argmin == static_cast<int64_t>(argmin));
+        CHECK(stats.max == data[argmax] && stats.argmax == static_cast<int64_t>(argmax));
+        CHECK(std::abs(stats.mean - mean) < 1e-9L * (1 + std::abs(mean)));
+        CHECK(std::abs(stats.variance - m2 / n) < 1e-9L * (1 + m2 / n));
+    }
+}
+
+void test_stats() {
+    std::mt19937 random(5);
+    check_stats<int>(random, 100);
+    check_stats<int64_t>(random, 100);
+    check_stats<float>(random, 100);
+    check_stats<double>(random, 100);
+    check_stats<uint8_t>(random, 0);
+
+    includecpp::FastStats empty = includecpp::fast_stats(std::vector<int>());
+    CHECK(empty.count == 0 && empty.sum == 0 && empty.variance == 0);
+
+    // Values far from zero: the shifted sums must not cancel
+    std::vector<double> offset(1000);
+    for (size_t i = 0; i < offset.size(); i++) offset[i] = 1e9 + (i % 2);
+    CHECK(std::abs(includecpp::fast_stats_n(offset.data(), offset.size()).variance - 0.25) < 1e-6);
+}
+
+
+// Every element type has its own std::vector overload of the free functions
+void test_vector_overloads() {
+    std::vector<double> prices = {3.5, -1.25, 2.0};
+    CHECK(includecpp::fast_sort(prices) == std::vector<double>({-1.25, 2.0, 3.5}));
+    CHECK(includecpp::fast_sum(prices) == 4.25);
+    CHECK(includecpp::fast_argsort(prices, true) == std::vector<int>({1, 2, 0}));
+
+    std::vector<int64_t> stamps = {int64_t(1) << 40, 3, int64_t(1) << 41};
+    CHECK(includecpp::fast_max(stamps) == int64_t(1) << 41);
+    CHECK(includecpp::fast_topk(stamps, 1) == std::vector<int64_t>({int64_t(1) << 41}));
+
+    std::vector<float> features = {0.5f, 0.25f};
+    CHECK(includecpp::fast_min(features) == 0.25f);
+    CHECK(includecpp::fast_reverse(features) == std::vector<float>({0.25f, 0.5f}));
+
+    std::vector<uint8_t> bytes = {200, 100, 250};
+    CHECK(includecpp::fast_sum(bytes) == 550);
+    CHECK(includecpp::fast_nth(bytes, 1) == 200);
+    CHECK(includecpp::fast_sort_by_key(bytes, std::vector<uint8_t>({1, 2, 3})) == std::vector<uint8_t>({2, 1, 3}));
+}
+
+
+// fast_sort_into / fast_reverse_into size out like the input inside its
+// existing storage, and work in place when source is out
+void test_into_variants() {
+    includecpp::FastList source;
+    source.extend({5, -2, 9, 0, 3});
+    includecpp::FastList out;
+    out.reserve(64);
+    out.extend({7, 7, 7, 7, 7, 7, 7, 7});
+    out.set_track_aggregates(true);
+    CHECK(out.maximum() == 7);
+    const int* storage = out.data.data();
+    includecpp::fast_sort_into(source, out);
+    CHECK(out.data == std::vector<int>({-2, 0, 3, 5, 9}));
+    CHECK(source.data == std::vector<int>({5, -2, 9, 0, 3}));
+    CHECK(out.data.data() == storage && out.capacity() >= 64);
+    CHECK(out.maximum() == 9 && out.sum() == 15);
+    includecpp::fast_reverse_into(source, out);
+    CHECK(out.data == std::vector<int>({3, 0, 9, -2, 5}));
+    CHECK(out.data.data() == storage);
+
+    // Growing an empty out, then aliasing source and out
+    includecpp::FastListF64 floats;
+    floats.extend({2.5, -1.0, 7.0});
+    includecpp::FastListF64 sorted;
+    includecpp::fast_sort_into(floats, sorted);
+    CHECK(sorted.data == std::vector<double>({-1.0, 2.5, 7.0}));
+    includecpp::fast_reverse_into(floats, floats);
+    CHECK(floats.data == std::vector<double>({7.0, -1.0, 2.5}));
+    includecpp::fast_sort_into(floats, floats);
+    CHECK(floats.data == sorted.data);
+
+    // In place on the radix and pooled paths
+    std::mt19937 random(66);
+    includecpp::FastListI64 large;
+    for (int i = 0; i < 300000; i++) large.add(static_cast<int64_t>(random()) - (int64_t(1) << 31));
+    std::vector<int64_t> expected = large.data;
+    std::sort(expected.begin(), expected.end());
+    large.set_range_sum_index("prefix");
+    CHECK(large.range_sum(0, 10) == naive_sum(large.data, 0, 10));
+    includecpp::fast_sort_into(large, large);
+    CHECK(large.data == expected);
+    CHECK(large.range_sum(0, 10) == naive_sum(expected, 0, 10));
+    includecpp::fast_reverse_into(large, large);
+    CHECK(std::equal(large.data.begin(), large.data.end(), expected.rbegin()));
+}
+
+
+// Random values spanning the type's range; floats add signed zeros and infinities
+template <typename T>
+std::vector<T> random_values(std::mt19937_64& random, size_t n) {
+    std::vector<T> data(n);
+    for (auto& value : data) {
+        if (std::is_integral<T>::value) {
+            value = static_cast<T>(random());
+        } else {
+            value = static_cast<T>(std::ldexp(static_cast<double>(static_cast<int64_t>(random())), -static_cast<int>(random() % 80)));
+        }
+    }
+    if (!std::is_integral<T>::value && n >= 4) {
+        data[0] = static_cast<T>(-0.0);
+        data[1] = 0;
+        data[2] = std::numeric_limits<T>::infinity();
+        data[3] = -std::numeric_limits<T>::infinity();
+    }
+    return data;
+}
+
+// fast_sort_n matches std::sort on both sides of the radix thresholds
+template <typename T>
+void check_radix_sort(std::mt19937_64& random) {
+    for (size_t n : {0, 1, 2, 127, 128, 129, 2047, 2048, 2049, 100000, 1000000}) {
+        std::vector<T> data = random_values<T>(random, n);
+        std::vector<T> expected = data;
+        std::sort(expected.begin(), expected.end());
+        includecpp::fast_sort_n(data.data(), n);
+        CHECK(data == expected);
+    }
+    // Few distinct values leave most digit passes skippable
+    std::vector<T> repeated(5000);
+    for (auto& value : repeated) value = static_cast<T>(random() % 3);
+    std::vector<T> expected = repeated;
+    std::sort(expected.begin(), expected.end());
+    includecpp::fast_sort_n(repeated.data(), repeated.size());
+    CHECK(repeated == expected);
+}
+
+void test_radix_sort() {
+    std::mt19937_64 random(64);
+    const int threads = includecpp::fast_get_num_threads();
+    includecpp::fast_set_num_threads(1);
+    check_radix_sort<int>(random);
+    check_radix_sort<int64_t>(random);
+    check_radix_sort<float>(random);
+    check_radix_sort<double>(random);
+    check_radix_sort<uint8_t>(random);
+    includecpp::fast_set_num_threads(threads);
+}
+
+
+
+// The pooled radix sort gives the serial result for every thread count
+template <typename T>
+void check_parallel_sort(std::mt19937_64& random) {
+    for (size_t n : {size_t(1) << 17, size_t(300001), size_t(1000000)}) {
+        const std::vector<T> input = random_values<T>(random, n);
+        std::vector<T> expected = input;
+        std::sort(expected.begin(), expected.end());
+        for (int threads : {1, 4}) {
+            includecpp::fast_set_num_threads(threads);
+            std::vector<T> data = input;
+            includecpp::fast_sort_n(data.data(), n);
+            CHECK(data == expected);
+        }
+    }
+}
+
+void test_parallel_sort() {
+    std::mt19937_64 random(65);
+    const int threads = includecpp::fast_get_num_threads();
+    check_parallel_sort<int>(random);
+    check_parallel_sort<int64_t>(random);
+    check_parallel_sort<float>(random);
+    check_parallel_sort<double>(random);
+    check_parallel_sort<uint8_t>(random);
+
+    // Concurrent sorts share one pool; whichever finds it busy runs serially
+    includecpp::fast_set_num_threads(4);
+    std::vector<std::vector<int>> inputs;
+    for (int t = 0; t < 4; t++) inputs.push_back(random_values<int>(random, 400000));
+    std::vector<std::vector<int>> outputs = inputs;
+    std::vector<std::thread> sorters;
+    for (int t = 0; t < 4; t++) {
+        sorters.emplace_back([&outputs, t] { includecpp::fast_sort_n(outputs[t].data(), outputs[t].size()); });
+    }
+    for (auto& sorter : sorters) sorter.join();
+    for (int t = 0; t < 4; t++) {
+        std::sort(inputs[t].begin(), inputs[t].end());
+        CHECK(outputs[t] == inputs[t]);
+    }
+    includecpp::fast_set_num_threads(threads);
+}
+
+
+
+// topk, partial_sort, nth and quantiles agree with a full std::sort, on
+// both the serial and the pooled selection paths
+template <typename T>
+void check_selection(std::mt19937_64& random) {
+    const std::vector<double> qs = {0.0, 0.1, 0.25, 0.5, 0.9, 0.999, 1.0};
+    for (size_t n : {1, 2, 10, 1000, 300000, 1000000}) {
+        const std::vector<T> data = random_values<T>(random, n);
+        std::vector<T> sorted = data;
+        std::sort(sorted.begin(), sorted.end());
+        for (int threads : {1, 4}) {
+            includecpp::fast_set_num_threads(threads);
+            for (size_t k : {size_t(0), size_t(1), n / 3, n}) {
+                std::vector<T> out(k);
+                includecpp::fast_partial_sort_n(data.data(), n, k, out.data());
+                CHECK(std::equal(out.begin(), out.end(), sorted.begin()));
+                includecpp::fast_topk_n(data.data(), n, k, out.data());
+                CHECK(std::equal(out.begin(), out.end(), sorted.rbegin()));
+            }
+            for (size_t rank : {size_t(0), n / 2, n - 1}) {
+                CHECK(includecpp::fast_nth_n(data.data(), n, rank) == sorted[rank]);
+            }
+            CHECK(includecpp::fast_nth_n(data.data(), n, n) == 0);
+
+            std::vector<double> out(qs.size());
+            includecpp::fast_quantiles_n(data.data(), n, qs.data(), qs.size(), out.data());
+            for (size_t j = 0; j < qs.size(); j++) {
+                const double position = qs[j] * static_cast<double>(n - 1);
+                const size_t lower = static_cast<size_t>(position);
+                const double low = sorted[lower];
+                const double high = sorted[std::min(lower + 1, n - 1)];
+                const double expected = low + (position - static_cast<double>(lower)) * (high - low);
+                CHECK(out[j] == expected || (out[j] != out[j] && expected != expected));  // inf - inf
+            }
+        }
+    }
+}
+
+void test_selection() {
+    std::mt19937_64 random(74);
+    const int threads = includecpp::fast_get_num_threads();
+    check_selection<int>(random);
+    check_selection<int64_t>(random);
+    check_selection<float>(random);
+    check_selection<double>(random);
+    check_selection<uint8_t>(random);
+    includecpp::fast_set_num_threads(threads);
+}
+
+
+
+// partial_sorted(k) is the first min(k, n) elements of std::partial_sort,
+// empty for k <= 0
+template <typename List>
+void check_partial_sorted(List& list) {
+    using T = typename decltype(list.data)::value_type;
+    const int n = list.size();
+    for (int k : {-3, -1, 0, 1, 2, n / 2, n - 1, n, n + 1, n + 100}) {
+        std::vector<T> expected = list.data;
+        const int taken = std::max(0, std::min(k, n));
+        std::partial_sort(expected.begin(), expected.begin() + taken, expected.end());
+        expected.resize(taken);
+        CHECK(list.partial_sorted(k).data == expected);
+    }
+}
+
+void test_partial_sorted() {
+    std::mt19937 random(74);
+    includecpp::FastList ints;
+    for (int i = 0; i < 1000; i++) ints.add(static_cast<int>(random() % 100) - 50);
+    const std::vector<int> before = ints.data;
+    check_partial_sorted(ints);
+    CHECK(ints.data == before);     // The list itself is not reordered
+    includecpp::FastListF64 floats;
+    floats.extend({2.5, -1.0, 7.0, 0.5, -1.0});
+    check_partial_sorted(floats);
+    includecpp::FastListU8 empty;
+    check_partial_sorted(empty);
+}
+
+// Total order of the sorts: -0.0 before 0.0 (no NaNs in these inputs)
+template <typename T>
+bool sort_less(T a, T b) {
+    return a < b || (a == b && std::signbit(static_cast<double>(a)) && !std::signbit(static_cast<double>(b)));
+}
+
+// fast_argsort_n: stable matches std::stable_sort of the indices; unstable
+// is a permutation that sorts the data
+template <typename T>
+void check_argsort(std::mt19937_64& random) {
+    for (size_t n : {0, 1, 100, 2047, 2049, 300000, 1000000}) {
+        std::vector<T> data = random_values<T>(random, n);
+        for (size_t i = n / 2; i > 0 && i < n; i++) data[i] = data[random() % (n / 2)];   // Ties
+        std::vector<int> expected(n);
+        for (size_t i = 0; i < n; i++) expected[i] = static_cast<int>(i);
+        std::stable_sort(expected.begin(), expected.end(),
+                         [&](int a, int b) { return sort_less(data[a], data[b]); });
+        for (int threads : {1, 4}) {
+            includecpp::fast_set_num_threads(threads);
+            std::vector<int> order(n);
+            includecpp::fast_argsort_n(data.data(), n, true, order.data());
+            CHECK(order == expected);
+
+            includecpp::fast_argsort_n(data.data(), n, false, order.data());
+            std::vector<bool> seen(n, false);
+            bool sorted = true;
+            for (size_t i = 0; i < n; i++) {
+                seen[order[i]] = true;
+                if (i > 0 && sort_less(data[order[i]], data[order[i - 1]])) sorted = false;
+            }
+            CHECK(sorted);
+            CHECK(std::find(seen.begin(), seen.end(), false) == seen.end());
+        }
+    }
+}
+
+void test_argsort() {
+    std::mt19937_64 random(75);
+    const int threads = includecpp::fast_get_num_threads();
+    check_argsort<int>(random);
+    check_argsort<int64_t>(random);
+    check_argsort<float>(random);
+    check_argsort<double>(random);
+    check_argsort<uint8_t>(random);
+    includecpp::fast_set_num_threads(threads);
+}
+
+
+
+// get follows the bounds policy like gather
+void test_get_bounds() {
+    includecpp::FastListF64 list;
+    list.extend({1.5, 2.5});
+    CHECK(list.get(5) == 0.0);
+    list.set_fill_value(-9.0);
+    CHECK(list.get(-1) == -9.0 && list.get(2) == -9.0);
+    list.set_bounds_policy("clip");
+    CHECK(list.get(-3) == 1.5 && list.get(7) == 2.5);
+    list.set_bounds_policy("raise");
+    CHECK(list.get(1) == 2.5);
+    bool threw = false;
+    try {
+        list.get(2);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    includecpp::FastListF64 empty;
+    empty.set_bounds_policy("clip");
+    CHECK(empty.get(0) == 0.0);   // Nothing to clip to: the fill value
+}
+
+}  // namespace
+
+int main() {
+    test_extreme_index_appends();
+    test_sliding_extremes();
+    test_range_sum_index_updates();
+    test_int32_range_sums();
+    test_aggregate_invalidation();
+    test_self_append();
+    test_extend_range();
+    test_capacity_controls();
+    test_view_pinning();
+    test_bounds_policies();
+    test_sort_by_key();
+    test_simd_sums();
+    test_stats();
+    test_vector_overloads();
+    test_into_variants();
+    test_radix_sort();
+    test_parallel_sort();
+    test_selection();
+    test_partial_sorted();
+    test_argsort();
+    test_get_bounds();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("fast_list: all checks passed\n");
+    return 0;
+}
@@ -7,26 +7,131 @@ PUBLIC(
     }
     solar_system CLASS(SolarSystem) {
         CONSTRUCTOR()
+        METHOD(add_test_particle, double, double, double, double, double, double, double)
         METHOD(calculate_angular_momentum)
         METHOD(calculate_total_energy)
         METHOD(get_body_count)
+        METHOD(get_body_metrics, std::vector<int>)
+        METHOD(get_cpu_topology)
         METHOD(get_distance_from_sun, int)
+        METHOD(get_distances_from_parent)
+        METHOD(get_distances_from_sun)
         METHOD(get_energy_error)
+        METHOD(get_force_engine)
+        METHOD(get_framebuffer)
+        METHOD(get_framebuffer_size)
+        METHOD(get_framebuffer_view)
+        METHOD(get_kinetic_energies)
         METHOD(get_masses)
         METHOD(get_names)
+        METHOD(get_num_processes)
+        METHOD(get_num_threads)
+        METHOD(get_opening_angle)
         METHOD(get_orbital_period, int)
+        METHOD(get_orbital_periods)
         METHOD(get_positions)
         METHOD(get_positions_au)
         METHOD(get_radii)
+        METHOD(get_regularization_radius)
+        METHOD(get_regularized_pair_count)
+        METHOD(get_render_height)
+        METHOD(get_render_width)
+        METHOD(get_reproducible)
         METHOD(get_simulation_time)
         METHOD(get_simulation_time_days)
         METHOD(get_simulation_time_years)
         METHOD(get_speed, int)
+        METHOD(get_speeds)
+        METHOD(get_state_transition_matrix, int)
         METHOD(get_step_count)
+        METHOD(get_thread_affinity)
         METHOD(get_total_energy)
         METHOD(get_trajectory, int)
+        METHOD(get_variational)
         METHOD(get_velocities)
         METHOD(init_real_solar_system)
+        METHOD(load_checkpoint, std::string)
+        METHOD(refresh_energy)
+        METHOD(render, bool, int)
+        METHOD(reset_state_transition_matrices)
+        METHOD(save_checkpoint, std::string)
+        METHOD(set_autotune_cache, std::string)
+        METHOD(set_camera, double, double, double)
+        METHOD(set_force_engine, std::string)
+        METHOD(set_force_error_bound, double)
+        METHOD(set_num_processes, int)
+        METHOD(set_num_threads, int)
+        METHOD(set_opening_angle, double)
+        METHOD(set_regularization_radius, double)
+        METHOD(set_render_size, int, int)
+        METHOD(set_reproducible, bool)
+        METHOD(set_thread_affinity, bool)
+        METHOD(set_variational, bool)
+        METHOD(simulate, double, double)
+        METHOD(step, double)
+    }
+    solar_system CLASS(PerturbedSolarSystem) {
+        CONSTRUCTOR()
+        METHOD(add_test_particle, double, double, double, double, double, double, double)
+        METHOD(calculate_angular_momentum)
+        METHOD(calculate_total_energy)
+        METHOD(get_body_count)
+        METHOD(get_body_metrics, std::vector<int>)
+        METHOD(get_cpu_topology)
+        METHOD(get_distance_from_sun, int)
+        METHOD(get_distances_from_parent)
+        METHOD(get_distances_from_sun)
+        METHOD(get_energy_error)
+        METHOD(get_force_engine)
+        METHOD(get_framebuffer)
+        METHOD(get_framebuffer_size)
+        METHOD(get_framebuffer_view)
+        METHOD(get_kinetic_energies)
+        METHOD(get_masses)
+        METHOD(get_names)
+        METHOD(get_num_processes)
+        METHOD(get_num_threads)
+        METHOD(get_opening_angle)
+        METHOD(get_orbital_period, int)
+        METHOD(get_orbital_periods)
+        METHOD(get_positions)
+        METHOD(get_positions_au)
+        METHOD(get_radii)
+        METHOD(get_regularization_radius)
+        METHOD(get_regularized_pair_count)
+        METHOD(get_render_height)
+        METHOD(get_render_width)
+        METHOD(get_reproducible)
+        METHOD(get_simulation_time)
+        METHOD(get_simulation_time_days)
+        METHOD(get_simulation_time_years)
+        METHOD(get_speed, int)
+        METHOD(get_speeds)
+        METHOD(get_state_transition_matrix, int)
+        METHOD(get_step_count)
+        METHOD(get_thread_affinity)
+        METHOD(get_total_energy)
+        METHOD(get_trajectory, int)
+        METHOD(get_variational)
+        METHOD(get_velocities)
+        METHOD(init_real_solar_system)
+        METHOD(load_checkpoint, std::string)
+        METHOD(refresh_energy)
+        METHOD(render, bool, int)
+        METHOD(reset_state_transition_matrices)
+        METHOD(save_checkpoint, std::string)
+        METHOD(set_autotune_cache, std::string)
+        METHOD(set_camera, double, double, double)
+        METHOD(set_force_engine, std::string)
+        METHOD(set_force_error_bound, double)
+        METHOD(set_num_processes, int)
+        METHOD(set_num_threads, int)
+        METHOD(set_opening_angle, double)
+        METHOD(set_regularization_radius, double)
+        METHOD(set_render_size, int, int)
+        METHOD(set_reproducible, bool)
+        METHOD(set_thread_affinity, bool)
+        METHOD(set_variational, bool)
         METHOD(simulate, double, double)
         METHOD(step, double)
     }
@@ -35,4 +140,5 @@ PUBLIC(
     solar_system FUNCTION(get_DAY)
     solar_system FUNCTION(get_G)
     solar_system FUNCTION(get_YEAR)
+    solar_system FUNCTION(run_checkpoint_ensemble)
 )
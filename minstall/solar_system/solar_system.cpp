@@ -4,6 +4,8 @@
  * All data from NASA JPL Horizons Database
  * Units: SI (meters, kg, seconds)
  * Integration: Velocity Verlet (symplectic, energy-conserving)
+ * Forces: Newtonian point-mass gravity plus optional compile-time
+ *         perturbation terms (J2 oblateness, 1PN relativity, radiation pressure)
  *
  * Includes: Sun, 8 Planets, Pluto, Major Moons
  */
@@ -13,6 +15,39 @@
 #include <string>
 #include <unordered_map>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <csignal>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Module builds compile against pybind11, which the framebuffer view needs;
+// the standalone driver, test and benchmark builds have neither it nor Python.h
+#if __has_include(<pybind11/pybind11.h>) && __has_include(<Python.h>)
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#define SOLAR_SYSTEM_PYTHON 1
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -25,6 +60,8 @@ constexpr double GRAV = 6.67430e-11;        // Gravitational constant [m³/(kg·
 constexpr double AU = 1.495978707e11;       // Astronomical Unit [m]
 constexpr double DAY = 86400.0;             // Seconds per day
 constexpr double YEAR = 365.25 * DAY;       // Seconds per year
+constexpr double C_LIGHT = 299792458.0;     // Speed of light [m/s]
+constexpr double SOLAR_PRESSURE = 4.56e-6;  // Solar radiation pressure at 1 AU [N/m²]
 
 // Celestial Body with full orbital mechanics
 struct CelestialBody {
@@ -38,6 +75,11 @@ struct CelestialBody {
     double radius;          // [m]
     double obliquity;       // Axial tilt [radians]
     double rotation_period; // [seconds]
+    double j2;              // Oblateness coefficient (dimensionless)
+
+    // Radiation pressure (test particles)
+    double area_to_mass;    // Cross-section over mass [m²/kg]
+    double reflectivity;    // Radiation pressure coefficient Cr (1 = absorbing, 2 = mirror)
 
     // State vectors (heliocentric or parent-centric for moons)
     double x, y, z;         // Position [m]
@@ -59,11 +101,15 @@ struct CelestialBody {
     std::vector<double> trajectory_z;
     int trajectory_max_points;
 
+    // Display
+    uint32_t color;         // 0xRRGGBB used by the rasterizer
+
     CelestialBody() : id(0), parent_id(-1), mass(0), radius(0), obliquity(0),
-                      rotation_period(0), x(0), y(0), z(0), vx(0), vy(0), vz(0),
+                      rotation_period(0), j2(0), area_to_mass(0), reflectivity(1),
+                      x(0), y(0), z(0), vx(0), vy(0), vz(0),
                       ax(0), ay(0), az(0), ax_old(0), ay_old(0), az_old(0),
                       semi_major_axis(0), eccentricity(0), inclination(0),
-                      orbital_period(0), trajectory_max_points(1000) {}
+                      orbital_period(0), trajectory_max_points(1000), color(0xFFFFFF) {}
 
     void add_trajectory_point() {
         trajectory_x.push_back(x);
@@ -77,49 +123,1937 @@ struct CelestialBody {
     }
 };
 
-class SolarSystem {
+// ============================================================
+// FORCE TERMS
+// Perturbations added on top of Newtonian point-mass gravity. Each term is a
+// stateless policy passed as a template parameter to BasicSolarSystem, so the
+// enabled terms are inlined into the acceleration pass and disabled ones cost
+// nothing. Bodies are heliocentric with the Sun at index 0.
+// ============================================================
+
+// J2 zonal harmonic of every body with j2 != 0. The spin axis is the ecliptic
+// pole tilted by the body's obliquity about the x-axis.
+struct J2Oblateness {
+    static void apply(std::vector<CelestialBody>& bodies) {
+        for (size_t j = 0; j < bodies.size(); j++) {
+            const CelestialBody& planet = bodies[j];
+            if (planet.j2 == 0 || planet.mass == 0) continue;
+
+            double kx = 0;
+            double ky = -std::sin(planet.obliquity);
+            double kz = std::cos(planet.obliquity);
+            double coeff = -1.5 * planet.j2 * GRAV * planet.mass * planet.radius * planet.radius;
+
+            for (size_t i = 0; i < bodies.size(); i++) {
+                if (i == j) continue;
+                double dx = bodies[i].x - planet.x;
+                double dy = bodies[i].y - planet.y;
+                double dz = bodies[i].z - planet.z;
+                double r_sq = dx*dx + dy*dy + dz*dz;
+                double r = std::sqrt(r_sq);
+                double z = dx*kx + dy*ky + dz*kz;
+
+                // a = -3/2 J2 GM R² / r⁵ * [(1 - 5 z²/r²) d + 2 z k]
+                double factor = coeff / (r_sq * r_sq * r);
+                double radial = 1.0 - 5.0 * z * z / r_sq;
+                double ax = factor * (radial * dx + 2.0 * z * kx);
+                double ay = factor * (radial * dy + 2.0 * z * ky);
+                double az = factor * (radial * dz + 2.0 * z * kz);
+
+                bodies[i].ax += ax;
+                bodies[i].ay += ay;
+                bodies[i].az += az;
+
+                // Equal and opposite reaction keeps total momentum conserved
+                double ratio = bodies[i].mass / planet.mass;
+                bodies[j].ax -= ratio * ax;
+                bodies[j].ay -= ratio * ay;
+                bodies[j].az -= ratio * az;
+            }
+        }
+    }
+};
+
+// First post-Newtonian (Schwarzschild) correction from the Sun.
+// Uses the velocities at the start of the step, like the rest of Velocity Verlet.
+struct PostNewtonian {
+    static void apply(std::vector<CelestialBody>& bodies) {
+        if (bodies.empty()) return;
+        const CelestialBody& sun = bodies[0];
+        double mu = GRAV * sun.mass;
+
+        for (size_t i = 1; i < bodies.size(); i++) {
+            double dx = bodies[i].x - sun.x;
+            double dy = bodies[i].y - sun.y;
+            double dz = bodies[i].z - sun.z;
+            double dvx = bodies[i].vx - sun.vx;
+            double dvy = bodies[i].vy - sun.vy;
+            double dvz = bodies[i].vz - sun.vz;
+            double r = std::sqrt(dx*dx + dy*dy + dz*dz);
+            double v_sq = dvx*dvx + dvy*dvy + dvz*dvz;
+            double r_dot_v = dx*dvx + dy*dvy + dz*dvz;
+
+            // a = GM / (c² r³) * [(4GM/r - v²) r + 4 (r·v) v]
+            double factor = mu / (C_LIGHT * C_LIGHT * r * r * r);
+            double radial = 4.0 * mu / r - v_sq;
+            bodies[i].ax += factor * (radial * dx + 4.0 * r_dot_v * dvx);
+            bodies[i].ay += factor * (radial * dy + 4.0 * r_dot_v * dvy);
+            bodies[i].az += factor * (radial * dz + 4.0 * r_dot_v * dvz);
+        }
+    }
+};
+
+// Solar radiation pressure on bodies with a nonzero area_to_mass (test particles)
+struct SolarRadiationPressure {
+    static void apply(std::vector<CelestialBody>& bodies) {
+        if (bodies.empty()) return;
+        const CelestialBody& sun = bodies[0];
+
+        for (size_t i = 1; i < bodies.size(); i++) {
+            if (bodies[i].area_to_mass == 0) continue;
+            double dx = bodies[i].x - sun.x;
+            double dy = bodies[i].y - sun.y;
+            double dz = bodies[i].z - sun.z;
+            double r_sq = dx*dx + dy*dy + dz*dz;
+            double r = std::sqrt(r_sq);
+
+            // a = Cr * P(1 AU) * (A/m) * (AU/r)² along the Sun-body line
+            double factor = bodies[i].reflectivity * SOLAR_PRESSURE * bodies[i].area_to_mass
+                            * (AU * AU / r_sq) / r;
+            bodies[i].ax += factor * dx;
+            bodies[i].ay += factor * dy;
+            bodies[i].az += factor * dz;
+        }
+    }
+};
+
+// ============================================================
+// KUSTAANHEIMO-STIEFEL REGULARIZATION
+// Close pairs are advanced as centre of mass plus relative Kepler motion.
+// The relative orbit is propagated in KS variables u (4D) with fictitious
+// time ds = dt / r, where the two-body problem becomes the harmonic
+// oscillator u'' = (h/2) u and the 1/r singularity disappears.
+// ============================================================
+
+// Stumpff functions c0..c3 of z, valid for elliptic (z > 0) and hyperbolic (z < 0) motion
+inline void stumpff(double z, double& c0, double& c1, double& c2, double& c3) {
+    if (std::abs(z) < 0.1) {
+        // c_k(z) = sum_n (-z)^n / (2n + k)!
+        c0 = c1 = c2 = c3 = 0;
+        double term0 = 1, term1 = 1, term2 = 0.5, term3 = 1.0 / 6.0;
+        for (int n = 0; n < 8; n++) {
+            c0 += term0; c1 += term1; c2 += term2; c3 += term3;
+            term0 *= -z / ((2*n + 1) * (2*n + 2));
+            term1 *= -z / ((2*n + 2) * (2*n + 3));
+            term2 *= -z / ((2*n + 3) * (2*n + 4));
+            term3 *= -z / ((2*n + 4) * (2*n + 5));
+        }
+    } else if (z > 0) {
+        double sz = std::sqrt(z);
+        c0 = std::cos(sz);
+        c1 = std::sin(sz) / sz;
+        c2 = (1 - c0) / z;
+        c3 = (sz - std::sin(sz)) / (z * sz);
+    } else {
+        double sz = std::sqrt(-z);
+        c0 = std::cosh(sz);
+        c1 = std::sinh(sz) / sz;
+        c2 = (c0 - 1) / -z;
+        c3 = (std::sinh(sz) - sz) / (-z * sz);
+    }
+}
+
+// Advance relative position r and velocity v of a two-body orbit with
+// gravitational parameter mu by physical time dt, using KS variables.
+// Negative dt runs the orbit backwards: Kepler motion is time-reversible,
+// so the drift reverses v, advances by |dt| and reverses v again.
+inline void ks_kepler_drift(double r[3], double v[3], double mu, double dt) {
+    if (!(dt > 0)) {
+        if (dt < 0) {
+            for (int k = 0; k < 3; k++) v[k] = -v[k];
+            ks_kepler_drift(r, v, mu, -dt);
+            for (int k = 0; k < 3; k++) v[k] = -v[k];
+        }
+        return;
+    }
+    double dist = std::sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+
+    // Position -> u (choose the fibre branch that avoids cancellation)
+    double u[4];
+    if (r[0] >= 0) {
+        u[0] = std::sqrt(0.5 * (dist + r[0]));
+        u[1] = r[1] / (2 * u[0]);
+        u[2] = r[2] / (2 * u[0]);
+        u[3] = 0;
+    } else {
+        u[1] = std::sqrt(0.5 * (dist - r[0]));
+        u[0] = r[1] / (2 * u[1]);
+        u[2] = 0;
+        u[3] = r[2] / (2 * u[1]);
+    }
+
+    // Velocity -> u' = 1/2 L^T(u) v
+    double up[4] = {
+        0.5 * ( u[0]*v[0] + u[1]*v[1] + u[2]*v[2]),
+        0.5 * (-u[1]*v[0] + u[0]*v[1] + u[3]*v[2]),
+        0.5 * (-u[2]*v[0] - u[3]*v[1] + u[0]*v[2]),
+        0.5 * ( u[3]*v[0] - u[2]*v[1] + u[1]*v[2])
+    };
+
+    // Two-body energy per unit reduced mass: h = (2|u'|² - mu) / r
+    double up_sq = up[0]*up[0] + up[1]*up[1] + up[2]*up[2] + up[3]*up[3];
+    double h = (2 * up_sq - mu) / dist;
+    double a_dot = u[0]*u[0] + u[1]*u[1] + u[2]*u[2] + u[3]*u[3];
+    double b_dot = u[0]*up[0] + u[1]*up[1] + u[2]*up[2] + u[3]*up[3];
+    double d_dot = up_sq;
+
+    // Physical time elapsed after fictitious time s: t(s) = integral of |u|² ds
+    auto elapsed = [&](double s, double& rate) {
+        double c0, c1, c2, c3;
+        stumpff(-2 * h * s * s, c0, c1, c2, c3);
+        double t = 0.5 * a_dot * s * (1 + c1) + 2 * b_dot * s * s * c2 + 2 * d_dot * s * s * s * c3;
+        double z1 = -0.5 * h * s * s;
+        stumpff(z1, c0, c1, c2, c3);
+        double cs = c0, ss = s * c1;
+        rate = 0;
+        for (int k = 0; k < 4; k++) {
+            double uk = u[k] * cs + up[k] * ss;
+            rate += uk * uk;
+        }
+        return t;
+    };
+
+    // Bracket the root, then safeguarded Newton on t(s) = dt (t is monotone
+    // and dt > 0 here, so the bracket grows towards positive s)
+    double rate;
+    double lo = 0, hi = dt / dist;
+    while (elapsed(hi, rate) < dt) {
+        lo = hi;
+        hi *= 2;
+    }
+    double s = 0.5 * (lo + hi);
+    for (int iter = 0; iter < 100; iter++) {
+        double t = elapsed(s, rate);
+        if (t < dt) lo = s; else hi = s;
+        double next = s - (t - dt) / rate;
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);
+        if (std::abs(next - s) <= 1e-15 * s) {
+            s = next;
+            break;
+        }
+        s = next;
+    }
+
+    // u(s) = u0 c0 + u0' s c1,  u'(s) = (h/2) u0 s c1 + u0' c0
+    double c0, c1, c2, c3;
+    stumpff(-0.5 * h * s * s, c0, c1, c2, c3);
+    double un[4], upn[4];
+    for (int k = 0; k < 4; k++) {
+        un[k] = u[k] * c0 + up[k] * s * c1;
+        upn[k] = 0.5 * h * u[k] * s * c1 + up[k] * c0;
+    }
+
+    // Back to physical space: r = L(u) u, v = 2 L(u) u' / |u|²
+    double rn = un[0]*un[0] + un[1]*un[1] + un[2]*un[2] + un[3]*un[3];
+    r[0] = un[0]*un[0] - un[1]*un[1] - un[2]*un[2] + un[3]*un[3];
+    r[1] = 2 * (un[0]*un[1] - un[2]*un[3]);
+    r[2] = 2 * (un[0]*un[2] + un[1]*un[3]);
+    v[0] = 2 * (un[0]*upn[0] - un[1]*upn[1] - un[2]*upn[2] + un[3]*upn[3]) / rn;
+    v[1] = 2 * (un[1]*upn[0] + un[0]*upn[1] - un[3]*upn[2] - un[2]*upn[3]) / rn;
+    v[2] = 2 * (un[2]*upn[0] + un[3]*upn[1] + un[0]*upn[2] + un[1]*upn[3]) / rn;
+}
+
+// ============================================================
+// CPU TOPOLOGY
+// NUMA nodes and their CPUs (restricted to the CPUs this process may use).
+// Read from sysfs on Linux; elsewhere a single node with every CPU.
+// ============================================================
+struct CpuTopology {
+    std::vector<std::vector<int>> nodes;    // CPU ids per NUMA node
+};
+
+// Parse a sysfs CPU list such as "0-3,8-11"
+inline std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = (dash == std::string::npos) ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+inline CpuTopology detect_cpu_topology() {
+    CpuTopology topology;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (int node = 0; ; node++) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in) break;
+        std::string line;
+        std::getline(in, line);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(line)) {
+            if (!have_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) topology.nodes.push_back(cpus);
+    }
+    if (topology.nodes.empty() && have_mask) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        topology.nodes.push_back(cpus);
+    }
+#endif
+    if (topology.nodes.empty()) {
+        std::vector<int> cpus;
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+        topology.nodes.push_back(cpus);
+    }
+    return topology;
+}
+
+// CPU for each of count workers: contiguous worker ranges share a node, so
+// the body rows a node's workers write stay together
+inline std::vector<int> plan_worker_cpus(const CpuTopology& topology, int count) {
+    std::vector<int> cpus(count);
+    const int nodes = static_cast<int>(topology.nodes.size());
+    std::vector<int> used(nodes, 0);
+    for (int w = 0; w < count; w++) {
+        int node = static_cast<int>(static_cast<long long>(w) * nodes / count);
+        const auto& node_cpus = topology.nodes[node];
+        cpus[w] = node_cpus[used[node]++ % node_cpus.size()];
+    }
+    return cpus;
+}
+
+// Pin the calling thread to one CPU; no-op where unsupported
+inline void pin_current_thread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// Page-aligned double arrays. The allocation is left unwritten, so under
+// Linux's first-touch policy each page lands on the node of the thread that
+// first writes it (large arrays come straight from fresh mmap pages).
+constexpr size_t PAGE_BYTES = 4096;
+constexpr int PAGE_DOUBLES = PAGE_BYTES / sizeof(double);
+
+struct PageArrayDelete {
+    void operator()(double* data) const { ::operator delete[](data, std::align_val_t(PAGE_BYTES)); }
+};
+using PageArray = std::unique_ptr<double[], PageArrayDelete>;
+
+inline PageArray make_page_array(size_t n) {
+    return PageArray(static_cast<double*>(::operator new[](std::max<size_t>(n, 1) * sizeof(double),
+                                                           std::align_val_t(PAGE_BYTES))));
+}
+
+// Rows [begin, end) of worker out of threads for n rows. Once every worker
+// gets a full page of doubles, boundaries fall on page multiples, so no page
+// of a row-indexed PageArray is written by two workers.
+inline void partition_rows(int n, int threads, int worker, int& begin, int& end) {
+    auto boundary = [n, threads](int w) {
+        if (w >= threads) return n;
+        int row = static_cast<int>(static_cast<long long>(n) * w / threads);
+        return (n / threads >= PAGE_DOUBLES) ? row / PAGE_DOUBLES * PAGE_DOUBLES : row;
+    };
+    begin = boundary(worker);
+    end = boundary(worker + 1);
+}
+
+// ============================================================
+// FORCE ENGINE THREAD POOL
+// Persistent workers for the threaded force engine and the renderer. The
+// calling thread acts as worker 0, so a pool of size 1 spawns no threads.
+// With worker_cpus, worker w > 0 pins itself to worker_cpus[w]; the caller
+// is never pinned.
+// ============================================================
+class ForceThreadPool {
+public:
+    explicit ForceThreadPool(int count, const std::vector<int>& worker_cpus = {})
+        : task(nullptr), generation(0), pending(0), stopping(false) {
+        for (int w = 1; w < count; w++) {
+            int cpu = (w < static_cast<int>(worker_cpus.size())) ? worker_cpus[w] : -1;
+            workers.emplace_back([this, w, cpu] {
+                if (cpu >= 0) pin_current_thread(cpu);
+                worker_loop(w);
+            });
+        }
+    }
+
+    ~ForceThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ForceThreadPool(const ForceThreadPool&) = delete;
+    ForceThreadPool& operator=(const ForceThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Run work(worker_index) on every worker and wait for all of them
+    void run(const std::function<void(int)>& work) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &work;
+            pending = static_cast<int>(workers.size());
+            generation++;
+        }
+        start_cv.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [this] { return pending == 0; });
+        task = nullptr;
+    }
+
+private:
+    void worker_loop(int index) {
+        size_t seen = 0;
+        while (true) {
+            const std::function<void(int)>* work;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                work = task;
+            }
+            (*work)(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            done_cv.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    const std::function<void(int)>* task;
+    size_t generation;
+    int pending;
+    bool stopping;
+};
+
+// ============================================================
+// MULTI-PROCESS TREE ENGINE (Linux)
+// Forked worker processes on one machine compute Barnes-Hut forces. Bodies
+// are ordered along the Morton (Z-order) curve of their bounding cube and
+// cut into one contiguous, equal-count domain per worker. A force pass runs
+// three phases, each ended by a barrier over one Unix socket pair per worker:
+//   build     every worker builds an octree of its domain and publishes the
+//             domain's bounding box
+//   exchange  every worker walks its tree against each other domain's box
+//             and writes that domain's locally essential tree (LET): cells
+//             far enough from the whole box as centre-of-mass pseudo bodies,
+//             everything else as bodies
+//   force     every worker sums its bodies' accelerations from its own tree
+//             and the LETs it received
+// Bodies, boxes and LETs live in one shared anonymous mapping created before
+// the fork, so nothing but the phase bytes is copied between processes.
+//
+// A cell whose bodies span extent s is used as a point mass when
+// s < theta * d, d being the distance from its centre of mass to the target
+// body (own tree) or to the nearest point of the target domain's box (LET).
+// theta = 0 opens every cell: direct-summation forces in another order.
+//
+// Workers are created with fork(), which copies the whole parent: a child of
+// a multithreaded process inherits mutexes other threads held and, inside
+// Python, half-updated interpreter state. The group therefore refuses to
+// fork when the process runs any thread but the caller (the system's own
+// pools are shut down first); the engine then falls back to direct.
+// ============================================================
+
+// The low 21 bits of v spread to every third bit
+inline uint64_t spread_bits_3(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+class DomainForceGroup {
+public:
+    static constexpr int MORTON_LEVELS = 21;    // Bits per axis of a Morton key
+    static constexpr int LEAF_BODIES = 8;       // Bodies a tree leaf holds at most
+
+    // count workers for up to capacity bodies. let_capacity is the number of
+    // LET entries one worker can send another; no LET exceeds the sender's
+    // body count, so it is capped at the largest domain.
+    DomainForceGroup(int count, size_t capacity, size_t let_capacity)
+        : workers(std::max(1, count)), max_bodies(capacity),
+          let_slots(std::max<size_t>(1, std::min(let_capacity, largest_domain(std::max(1, count), capacity)))),
+          mapping(nullptr), mapping_size(0) {
+#ifdef __linux__
+        if (process_thread_count() != 1) return;
+
+        const size_t domains = static_cast<size_t>(workers);
+        mapping_size = ((domains + 1) + domains * domains) * sizeof(long long)  // bounds, LET sizes
+                       + (1 + 6 * domains) * sizeof(double)                         // theta, boxes
+                       + max_bodies * (sizeof(uint64_t) + 7 * sizeof(double) + sizeof(long long))
+                       + domains * domains * let_slots * 4 * sizeof(double);
+        void* memory = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return;
+        mapping = static_cast<char*>(memory);
+
+        char* next = mapping;   // Every array is a multiple of 8 bytes
+        auto take = [&next](size_t bytes) { char* start = next; next += bytes; return start; };
+        bounds = reinterpret_cast<long long*>(take((domains + 1) * sizeof(long long)));
+        let_count = reinterpret_cast<long long*>(take(domains * domains * sizeof(long long)));
+        theta = reinterpret_cast<double*>(take(sizeof(double)));
+        boxes = reinterpret_cast<double*>(take(6 * domains * sizeof(double)));
+        key = reinterpret_cast<uint64_t*>(take(max_bodies * sizeof(uint64_t)));
+        x = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        y = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        z = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        m = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        ax = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        ay = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        az = reinterpret_cast<double*>(take(max_bodies * sizeof(double)));
+        id = reinterpret_cast<long long*>(take(max_bodies * sizeof(long long)));
+        let = reinterpret_cast<double*>(take(domains * domains * let_slots * 4 * sizeof(double)));
+
+        for (int w = 0; w < workers; w++) {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) break;
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(fds[0]);
+                close(fds[1]);
+                break;
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                for (int fd : sockets) close(fd);
+                worker_main(w, fds[1]);
+            }
+            close(fds[1]);
+            sockets.push_back(fds[0]);
+            pids.push_back(pid);
+        }
+#endif
+    }
+
+    ~DomainForceGroup() {
+#ifdef __linux__
+        for (size_t w = 0; w < sockets.size(); w++) {
+            char command = 'q';
+            if (send(sockets[w], &command, 1, MSG_NOSIGNAL) != 1) kill(pids[w], SIGTERM);
+            close(sockets[w]);
+            waitpid(pids[w], nullptr, 0);
+        }
+        if (mapping) munmap(mapping, mapping_size);
+#endif
+    }
+
+    DomainForceGroup(const DomainForceGroup&) = delete;
+    DomainForceGroup& operator=(const DomainForceGroup&) = delete;
+
+    bool ok() const { return mapping != nullptr && static_cast<int>(pids.size()) == workers; }
+    int size() const { return workers; }
+    size_t capacity() const { return max_bodies; }
+    size_t let_capacity() const { return let_slots; }
+
+    // Bodies in the largest of count equal-count domains of n bodies
+    static size_t largest_domain(int count, size_t n) {
+        return (n + count - 1) / count;
+    }
+
+    // Order the bodies along the Morton curve of their bounding cube and give
+    // each worker an equal share of the curve
+    template <class Body>
+    void decompose(const std::vector<Body>& bodies) {
+        const size_t n = bodies.size();
+        double lo[3] = {INFINITY, INFINITY, INFINITY};
+        double hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+        for (const Body& body : bodies) {
+            const double p[3] = {body.x, body.y, body.z};
+            for (int a = 0; a < 3; a++) {
+                lo[a] = std::min(lo[a], p[a]);
+                hi[a] = std::max(hi[a], p[a]);
+            }
+        }
+        double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+        if (!(extent > 0) || !std::isfinite(extent)) extent = 1;
+        const double cells = static_cast<double>(1 << MORTON_LEVELS);
+        auto cell = [&](double v, int a) {
+            double t = (v - lo[a]) / extent * cells;
+            t = t > 0 ? t : 0;      // NaN lands in cell 0
+            return static_cast<uint64_t>(std::min(t, cells - 1));
+        };
+
+        order.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const Body& body = bodies[i];
+            const uint64_t code = spread_bits_3(cell(body.x, 0)) << 2
+                                | spread_bits_3(cell(body.y, 1)) << 1
+                                | spread_bits_3(cell(body.z, 2));
+            order[i] = {code, static_cast<long long>(i)};
+        }
+        std::sort(order.begin(), order.end());
+        for (size_t k = 0; k < n; k++) {
+            const Body& body = bodies[order[k].second];
+            key[k] = order[k].first;
+            id[k] = order[k].second;
+            x[k] = body.x; y[k] = body.y; z[k] = body.z;
+            m[k] = body.mass;
+        }
+        for (int w = 0; w <= workers; w++) {
+            bounds[w] = static_cast<long long>(n) * w / workers;
+        }
+    }
+
+    // Run the build, exchange and force phases with opening angle
+    // opening_angle. Returns false if a worker failed, or if a LET outgrew
+    // let_capacity(); needed is then the capacity every LET fits in (0 for a
+    // failed worker).
+    bool compute(double opening_angle, size_t& needed) {
+        needed = 0;
+        *theta = opening_angle;
+        if (!run_phase('b') || !run_phase('l')) return false;
+        long long largest = 0;
+        for (int k = 0; k < workers * workers; k++) largest = std::max(largest, let_count[k]);
+        if (static_cast<size_t>(largest) > let_slots) {
+            needed = static_cast<size_t>(largest);
+            return false;
+        }
+        return run_phase('f');
+    }
+
+    // Bodies in Morton order after decompose: id holds their original index,
+    // ax/ay/az their accelerations after compute
+    double *x = nullptr, *y = nullptr, *z = nullptr, *m = nullptr;
+    double *ax = nullptr, *ay = nullptr, *az = nullptr;
+    long long* id = nullptr;
+
+private:
+    struct Cell {
+        long long begin, end;       // Bodies, in Morton order
+        int first_child;            // Into the child list
+        int child_count;            // 0 for a leaf
+        double mass;
+        double cx, cy, cz;          // Centre of mass (box centre when massless)
+        double lo[3], hi[3];        // Bounding box of the bodies
+        double extent;              // Longest side of the box
+    };
+
+    // Send one phase command to every worker and wait for all of them
+    bool run_phase(char command) {
+#ifdef __linux__
+        for (int fd : sockets) {
+            if (send(fd, &command, 1, MSG_NOSIGNAL) != 1) return false;
+        }
+        bool success = true;
+        for (int fd : sockets) {
+            char reply = 0;
+            if (read(fd, &reply, 1) != 1 || reply != 'd') success = false;
+        }
+        return success;
+#else
+        (void)command;
+        return false;
+#endif
+    }
+
+    // Threads in this process, from /proc/self/status (0 if unknown)
+    static int process_thread_count() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 8, "Threads:") == 0) return std::atoi(line.c_str() + 8);
+        }
+        return 0;
+    }
+
+    // Octree cell of the Morton-ordered bodies [begin, end), which share the
+    // key bits above level; its descendants follow it in cells
+    int build_cell(long long begin, long long end, int level) {
+        const int index = static_cast<int>(cells.size());
+        cells.emplace_back();
+        Cell cell = {};
+        cell.begin = begin;
+        cell.end = end;
+        for (int a = 0; a < 3; a++) {
+            cell.lo[a] = INFINITY;
+            cell.hi[a] = -INFINITY;
+        }
+        double mx = 0, my = 0, mz = 0;
+        if (end - begin > LEAF_BODIES && level < MORTON_LEVELS) {
+            const int shift = 3 * (MORTON_LEVELS - 1 - level);
+            int child[8];
+            int count = 0;
+            for (long long start = begin; start < end;) {
+                const uint64_t octant = (key[start] >> shift) & 7;
+                long long stop = start;
+                while (stop < end && ((key[stop] >> shift) & 7) == octant) stop++;
+                child[count++] = build_cell(start, stop, level + 1);
+                start = stop;
+            }
+            cell.first_child = static_cast<int>(children.size());
+            cell.child_count = count;
+            for (int c = 0; c < count; c++) {
+                const Cell& part = cells[child[c]];
+                children.push_back(child[c]);
+                cell.mass += part.mass;
+                mx += part.mass * part.cx; my += part.mass * part.cy; mz += part.mass * part.cz;
+                for (int a = 0; a < 3; a++) {
+                    cell.lo[a] = std::min(cell.lo[a], part.lo[a]);
+                    cell.hi[a] = std::max(cell.hi[a], part.hi[a]);
+                }
+            }
+        }
+        else {
+            for (long long j = begin; j < end; j++) {
+                const double p[3] = {x[j], y[j], z[j]};
+                cell.mass += m[j];
+                mx += m[j] * x[j]; my += m[j] * y[j]; mz += m[j] * z[j];
+                for (int a = 0; a < 3; a++) {
+                    cell.lo[a] = std::min(cell.lo[a], p[a]);
+                    cell.hi[a] = std::max(cell.hi[a], p[a]);
+                }
+            }
+        }
+        if (cell.mass > 0) {
+            cell.cx = mx / cell.mass; cell.cy = my / cell.mass; cell.cz = mz / cell.mass;
+        }
+        else {
+            cell.cx = 0.5 * (cell.lo[0] + cell.hi[0]);
+            cell.cy = 0.5 * (cell.lo[1] + cell.hi[1]);
+            cell.cz = 0.5 * (cell.lo[2] + cell.hi[2]);
+        }
+        cell.extent = std::max({cell.hi[0] - cell.lo[0], cell.hi[1] - cell.lo[1], cell.hi[2] - cell.lo[2]});
+        cells[index] = cell;
+        return index;
+    }
+
+    // Pull of a point mass at (sx, sy, sz) on (px, py, pz), same expression as
+    // the direct engine
+    static void add_pull(double px, double py, double pz, double sx, double sy, double sz,
+                         double mass, double& sum_x, double& sum_y, double& sum_z) {
+        double dx = sx - px;
+        double dy = sy - py;
+        double dz = sz - pz;
+        double r_sq = dx*dx + dy*dy + dz*dz;
+        double r = std::sqrt(r_sq);
+        double r_cubed = r_sq * r;
+        double factor = GRAV * mass / r_cubed;
+        sum_x += factor * dx;
+        sum_y += factor * dy;
+        sum_z += factor * dz;
+    }
+
+    // LET of this worker's tree for a domain with bounding box box (lo, hi),
+    // written to slot; returns the entry count, which may exceed let_slots
+    long long emit_let(const double* box, double* slot, double opening_angle) {
+        long long count = 0;
+        auto emit = [&](double ex, double ey, double ez, double mass) {
+            if (static_cast<size_t>(count) < let_slots) {
+                double* entry = slot + 4 * count;
+                entry[0] = ex; entry[1] = ey; entry[2] = ez; entry[3] = mass;
+            }
+            count++;
+        };
+        stack.assign(1, 0);
+        while (!stack.empty()) {
+            const Cell& cell = cells[stack.back()];
+            stack.pop_back();
+            if (cell.mass == 0) continue;
+            const double c[3] = {cell.cx, cell.cy, cell.cz};
+            double gap_sq = 0;
+            for (int a = 0; a < 3; a++) {
+                const double gap = std::max(box[a] - c[a], c[a] - box[3 + a]);
+                if (gap > 0) gap_sq += gap * gap;
+            }
+            if (cell.extent < opening_angle * std::sqrt(gap_sq)) {
+                emit(cell.cx, cell.cy, cell.cz, cell.mass);
+            }
+            else if (cell.child_count == 0) {
+                for (long long j = cell.begin; j < cell.end; j++) {
+                    if (m[j] != 0) emit(x[j], y[j], z[j], m[j]);
+                }
+            }
+            else {
+                for (int c = cell.child_count - 1; c >= 0; c--) {
+                    stack.push_back(children[cell.first_child + c]);
+                }
+            }
+        }
+        return count;
+    }
+
+    // Acceleration of body i of this worker's domain from its own tree
+    void tree_pull(long long i, double opening_angle, double& sum_x, double& sum_y, double& sum_z) {
+        stack.assign(1, 0);
+        while (!stack.empty()) {
+            const Cell& cell = cells[stack.back()];
+            stack.pop_back();
+            if (cell.mass == 0) continue;
+            const bool holds_target = i >= cell.begin && i < cell.end;
+            if (!holds_target) {
+                double dx = cell.cx - x[i], dy = cell.cy - y[i], dz = cell.cz - z[i];
+                if (cell.extent < opening_angle * std::sqrt(dx*dx + dy*dy + dz*dz)) {
+                    add_pull(x[i], y[i], z[i], cell.cx, cell.cy, cell.cz, cell.mass, sum_x, sum_y, sum_z);
+                    continue;
+                }
+            }
+            if (cell.child_count == 0) {
+                for (long long j = cell.begin; j < cell.end; j++) {
+                    if (j != i && m[j] != 0) add_pull(x[i], y[i], z[i], x[j], y[j], z[j], m[j], sum_x, sum_y, sum_z);
+                }
+            }
+            else {
+                for (int c = cell.child_count - 1; c >= 0; c--) {
+                    stack.push_back(children[cell.first_child + c]);
+                }
+            }
+        }
+    }
+
+    // One phase of worker w on its domain
+    void run_worker_phase(int w, char command) {
+        const long long begin = bounds[w], end = bounds[w + 1];
+        const double opening_angle = *theta;
+        if (command == 'b') {
+            cells.clear();
+            children.clear();
+            if (begin == end) return;
+            build_cell(begin, end, 0);
+            for (int a = 0; a < 3; a++) {
+                boxes[6 * w + a] = cells[0].lo[a];
+                boxes[6 * w + 3 + a] = cells[0].hi[a];
+            }
+        }
+        else if (command == 'l') {
+            for (int d = 0; d < workers; d++) {
+                long long& count = let_count[w * workers + d];
+                count = 0;
+                if (d == w || begin == end || bounds[d] == bounds[d + 1]) continue;
+                count = emit_let(boxes + 6 * d, let_slot(w, d), opening_angle);
+            }
+        }
+        else if (command == 'f') {
+            for (long long i = begin; i < end; i++) {
+                double sum_x = 0, sum_y = 0, sum_z = 0;
+                tree_pull(i, opening_angle, sum_x, sum_y, sum_z);
+                for (int d = 0; d < workers; d++) {
+                    if (d == w) continue;
+                    const double* slot = let_slot(d, w);
+                    for (long long e = 0; e < let_count[d * workers + w]; e++) {
+                        const double* entry = slot + 4 * e;
+                        add_pull(x[i], y[i], z[i], entry[0], entry[1], entry[2], entry[3], sum_x, sum_y, sum_z);
+                    }
+                }
+                ax[i] = sum_x; ay[i] = sum_y; az[i] = sum_z;
+            }
+        }
+    }
+
+    // LET entries worker from sends worker to
+    double* let_slot(int from, int to) const {
+        return let + (static_cast<size_t>(from) * workers + to) * let_slots * 4;
+    }
+
+    // Worker process loop; ends with the process
+    [[noreturn]] void worker_main(int worker, int fd) {
+#ifdef __linux__
+        signal(SIGINT, SIG_IGN);    // Ctrl-C reaches the whole process group; the parent decides
+        try {
+            while (true) {
+                char command = 0;
+                if (read(fd, &command, 1) != 1 || command == 'q') _exit(0);
+                run_worker_phase(worker, command);
+                char reply = 'd';
+                if (send(fd, &reply, 1, MSG_NOSIGNAL) != 1) _exit(1);
+            }
+        }
+        catch (...) {
+            _exit(1);   // The parent sees the closed socket and falls back
+        }
+#else
+        (void)worker;
+        (void)fd;
+        std::abort();
+#endif
+    }
+
+    int workers;
+    size_t max_bodies;
+    size_t let_slots;
+    char* mapping;
+    size_t mapping_size;
+    long long* bounds = nullptr;        // Domain w is [bounds[w], bounds[w + 1])
+    long long* let_count = nullptr;     // Entries worker a sends worker b at [a * workers + b]
+    double* theta = nullptr;
+    double* boxes = nullptr;            // Domain bounding boxes (lo, hi)
+    uint64_t* key = nullptr;            // Morton keys
+    double* let = nullptr;
+    std::vector<int> sockets;
+    std::vector<int> pids;
+    std::vector<std::pair<uint64_t, long long>> order;     // Parent: sort buffer
+    std::vector<Cell> cells;                                // Worker: its domain's tree
+    std::vector<int> children;
+    std::vector<int> stack;
+};
+
+// a * b as a rounded double the compiler cannot fuse into a following add
+// (FMA). Contraction is decided per expression and per inlining site, and
+// only where the build allows it (-ffp-contract, -march), so reproducible
+// mode builds its sums from these products; other paths keep the build's
+// setting. The empty asm makes the product opaque without a memory trip.
+inline double unfused_mul(double a, double b) {
+    double product = a * b;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2_MATH__))
+    __asm__("" : "+x"(product));
+#elif defined(__GNUC__) && defined(__aarch64__)
+    __asm__("" : "+w"(product));
+#else
+    volatile double rounded = product;
+    product = rounded;
+#endif
+    return product;
+}
+
+// a * b, unfused when Unfused (reproducible mode)
+template <bool Unfused>
+inline double product(double a, double b) {
+    return Unfused ? unfused_mul(a, b) : a * b;
+}
+
+// Sum values with a fixed binary tree over blocks of 8. The result depends only
+// on the values, not on how they were produced, which makes reductions
+// bit-reproducible across thread counts.
+inline double pairwise_sum(const double* values, size_t n) {
+    if (n <= 8) {
+        double sum = 0;
+        for (size_t k = 0; k < n; k++) sum += values[k];
+        return sum;
+    }
+    size_t half = (n / 2 + 7) / 8 * 8;
+    return pairwise_sum(values, half) + pairwise_sum(values + half, n - half);
+}
+
+// Newtonian force engines selectable per SolarSystem (ForceTerms are applied on top)
+enum ForceEngine {
+    ENGINE_DIRECT = 0,      // Per-body loop over all others (reference)
+    ENGINE_PAIRWISE = 1,    // Each pair once, Newton's third law
+    ENGINE_TILED = 2,       // Pairwise over cache-sized blocks of SoA copies
+    ENGINE_THREADED = 3,    // Direct rows split across the thread pool
+    ENGINE_PROCESSES = 4,   // Tree code over forked worker processes (DomainForceGroup)
+    ENGINE_COUNT = 5
+};
+
+inline const char* force_engine_name(int engine) {
+    switch (engine) {
+        case ENGINE_DIRECT: return "direct";
+        case ENGINE_PAIRWISE: return "pairwise";
+        case ENGINE_TILED: return "tiled";
+        case ENGINE_THREADED: return "threaded";
+        case ENGINE_PROCESSES: return "processes";
+        default: return "auto";
+    }
+}
+
+// Identify the CPU for the autotune cache
+inline std::string cpu_signature() {
+    std::string model = "unknown";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) model = line.substr(colon + 2);
+            break;
+        }
+    }
+    std::replace(model.begin(), model.end(), '\t', ' ');
+    return model + " x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+// Per-user default for the autotune cache: under $XDG_CACHE_HOME, else
+// ~/.cache (%LOCALAPPDATA% on Windows); "" (no cache) if none is set
+inline std::string default_autotune_cache_path() {
+    std::string dir;
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (xdg && *xdg) {
+        dir = xdg;
+    } else if (home && *home) {
+        dir = std::string(home) + "/.cache";
+    }
+#ifdef _WIN32
+    const char* local = std::getenv("LOCALAPPDATA");
+    if (dir.empty() && local && *local) dir = local;
+#endif
+    return dir.empty() ? std::string() : dir + "/includecpp/solar_system_autotune.tsv";
+}
+
+// ============================================================
+// ORBIT RASTERIZER
+// CPU renderer for positions and trajectories into an RGBA8 framebuffer.
+// The image is split into horizontal bands that are rasterized in parallel;
+// every primitive is clipped to the band, so workers never share pixels.
+// ============================================================
+class OrbitRasterizer {
+public:
+    OrbitRasterizer() : width(0), height(0), center_x(0), center_y(0), half_width(3) {}
+
+    void resize(int w, int h) {
+        width = std::max(1, w);
+        height = std::max(1, h);
+        pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    }
+
+    // Camera centre and half of the horizontal extent, in AU
+    void set_camera(double cx, double cy, double half_extent) {
+        center_x = cx;
+        center_y = cy;
+        half_width = half_extent > 0 ? half_extent : half_width;
+    }
+
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+    uint8_t* data() { return pixels.data(); }
+    size_t byte_size() const { return pixels.size(); }
+
+    // World [AU] -> pixel coordinates, y pointing down
+    double to_px(double x_au) const { return (x_au - center_x) / half_width * 0.5 * width + 0.5 * width; }
+    double to_py(double y_au) const { return 0.5 * height - (y_au - center_y) / half_width * 0.5 * width; }
+
+    void fill_rows(int row_begin, int row_end, uint32_t rgb) {
+        for (int y = row_begin; y < row_end; y++) {
+            uint8_t* p = &pixels[static_cast<size_t>(y) * width * 4];
+            for (int x = 0; x < width; x++, p += 4) {
+                p[0] = (rgb >> 16) & 0xFF; p[1] = (rgb >> 8) & 0xFF; p[2] = rgb & 0xFF; p[3] = 0xFF;
+            }
+        }
+    }
+
+    // Xiaolin Wu anti-aliased line in pixel coordinates, limited to rows [row_begin, row_end)
+    void draw_line(double x0, double y0, double x1, double y1, uint32_t rgb, double alpha,
+                   int row_begin, int row_end) {
+        if (!clip_line(x0, y0, x1, y1, row_begin, row_end)) return;
+
+        bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+        if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+        if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+        double dx = x1 - x0;
+        double gradient = dx == 0 ? 1.0 : (y1 - y0) / dx;
+
+        auto plot = [&](int major, int minor, double coverage) {
+            if (steep) blend(minor, major, rgb, alpha * coverage, row_begin, row_end);
+            else blend(major, minor, rgb, alpha * coverage, row_begin, row_end);
+        };
+
+        // End points get partial coverage along the major axis
+        double xend = std::round(x0);
+        double yend = y0 + gradient * (xend - x0);
+        double xgap = 1.0 - (x0 + 0.5 - std::floor(x0 + 0.5));
+        int xpx1 = static_cast<int>(xend);
+        int ypx1 = static_cast<int>(std::floor(yend));
+        plot(xpx1, ypx1, (1.0 - (yend - ypx1)) * xgap);
+        plot(xpx1, ypx1 + 1, (yend - ypx1) * xgap);
+        double intery = yend + gradient;
+
+        xend = std::round(x1);
+        yend = y1 + gradient * (xend - x1);
+        xgap = x1 + 0.5 - std::floor(x1 + 0.5);
+        int xpx2 = static_cast<int>(xend);
+        int ypx2 = static_cast<int>(std::floor(yend));
+        plot(xpx2, ypx2, (1.0 - (yend - ypx2)) * xgap);
+        plot(xpx2, ypx2 + 1, (yend - ypx2) * xgap);
+
+        for (int x = xpx1 + 1; x < xpx2; x++) {
+            int y = static_cast<int>(std::floor(intery));
+            double frac = intery - y;
+            plot(x, y, 1.0 - frac);
+            plot(x, y + 1, frac);
+            intery += gradient;
+        }
+    }
+
+    // Anti-aliased filled disc, limited to rows [row_begin, row_end)
+    void draw_disc(double cx, double cy, double radius, uint32_t rgb, int row_begin, int row_end) {
+        int y_lo = std::max(row_begin, static_cast<int>(std::floor(cy - radius - 1)));
+        int y_hi = std::min(row_end - 1, static_cast<int>(std::ceil(cy + radius + 1)));
+        int x_lo = std::max(0, static_cast<int>(std::floor(cx - radius - 1)));
+        int x_hi = std::min(width - 1, static_cast<int>(std::ceil(cx + radius + 1)));
+        for (int y = y_lo; y <= y_hi; y++) {
+            for (int x = x_lo; x <= x_hi; x++) {
+                double dist = std::hypot(x + 0.5 - cx, y + 0.5 - cy);
+                double coverage = std::min(1.0, std::max(0.0, radius + 0.5 - dist));
+                if (coverage > 0) blend(x, y, rgb, coverage, row_begin, row_end);
+            }
+        }
+    }
+
+private:
+    void blend(int x, int y, uint32_t rgb, double a, int row_begin, int row_end) {
+        if (x < 0 || x >= width || y < row_begin || y >= row_end || a <= 0) return;
+        uint8_t* p = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+        a = std::min(1.0, a);
+        p[0] = static_cast<uint8_t>(p[0] + (static_cast<int>((rgb >> 16) & 0xFF) - p[0]) * a + 0.5);
+        p[1] = static_cast<uint8_t>(p[1] + (static_cast<int>((rgb >> 8) & 0xFF) - p[1]) * a + 0.5);
+        p[2] = static_cast<uint8_t>(p[2] + (static_cast<int>(rgb & 0xFF) - p[2]) * a + 0.5);
+        p[3] = 0xFF;
+    }
+
+    // Liang-Barsky clip to the framebuffer columns and the band rows. The 2 px
+    // margin keeps the partially covered end pixels of a clipped line outside
+    // the band, so bands join without seams.
+    bool clip_line(double& x0, double& y0, double& x1, double& y1, int row_begin, int row_end) const {
+        double t0 = 0, t1 = 1;
+        double dx = x1 - x0, dy = y1 - y0;
+        const double p[4] = {-dx, dx, -dy, dy};
+        const double q[4] = {x0 + 2, width + 1 - x0, y0 - (row_begin - 2), row_end + 1 - y0};
+        for (int k = 0; k < 4; k++) {
+            if (p[k] == 0) {
+                if (q[k] < 0) return false;
+                continue;
+            }
+            double t = q[k] / p[k];
+            if (p[k] < 0) t0 = std::max(t0, t);
+            else t1 = std::min(t1, t);
+            if (t0 > t1) return false;
+        }
+        double sx = x0, sy = y0;
+        x0 = sx + t0 * dx; y0 = sy + t0 * dy;
+        x1 = sx + t1 * dx; y1 = sy + t1 * dy;
+        return true;
+    }
+
+    int width, height;
+    double center_x, center_y, half_width;
+    std::vector<uint8_t> pixels;
+};
+
+template <typename... ForceTerms>
+class BasicSolarSystem {
 private:
     std::vector<CelestialBody> bodies;
     double simulation_time;     // Current time [seconds]
     double total_energy;        // System energy [J]
     double initial_energy;      // For conservation check
     int step_count;
+    std::vector<int> parent_index;  // Body index of each body's parent (-1 for Sun)
+
+    // KS regularization of close pairs (disabled when radius is 0)
+    double regularization_radius;   // Pairs closer than this are regularized [m]
+    std::vector<int> partner;       // Regularized partner of each body (-1 for none)
+
+    // Variational equations: per-body 6x6 state-transition matrix d(x,v)(t)/d(x,v)(t0),
+    // propagated with the body's own tidal tensor (other bodies held on their paths).
+    // Gradients of the ForceTerms perturbations are not included.
+    bool variational_enabled;
+    std::vector<double> stm;            // 36 per body, row-major
+    std::vector<double> gradient;       // 9 per body, da/dx at the current positions
+    std::vector<double> stm_kick_old;   // 18 per body, G_old * Phi_r at the start of the step
+
+    void reset_stm() {
+        stm.assign(bodies.size() * 36, 0.0);
+        for (size_t b = 0; b < bodies.size(); b++) {
+            for (int k = 0; k < 6; k++) {
+                stm[b * 36 + k * 6 + k] = 1.0;
+            }
+        }
+        gradient.assign(bodies.size() * 9, 0.0);
+        stm_kick_old.assign(bodies.size() * 18, 0.0);
+    }
+
+    // out (3x6) = G (3x3) * Phi_r (top 3 rows of Phi)
+    static void tidal_times_position_rows(const double* grad, const double* phi, double* out) {
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 6; col++) {
+                out[row * 6 + col] = grad[row * 3 + 0] * phi[0 * 6 + col]
+                                   + grad[row * 3 + 1] * phi[1 * 6 + col]
+                                   + grad[row * 3 + 2] * phi[2 * 6 + col];
+            }
+        }
+    }
+
+    // First half of Verlet for Phi: Phi_r += Phi_v dt + 0.5 G_old Phi_r dt²
+    void propagate_stm_positions(double dt) {
+        for (size_t b = 0; b < bodies.size(); b++) {
+            double* phi = &stm[b * 36];
+            double* kick = &stm_kick_old[b * 18];
+            tidal_times_position_rows(&gradient[b * 9], phi, kick);
+            for (int k = 0; k < 18; k++) {
+                phi[k] += phi[18 + k] * dt + 0.5 * kick[k] * dt * dt;
+            }
+        }
+    }
+
+    // Second half: Phi_v += 0.5 (G_old Phi_r_old + G_new Phi_r_new) dt
+    void propagate_stm_velocities(double dt) {
+        double kick_new[18];
+        for (size_t b = 0; b < bodies.size(); b++) {
+            double* phi = &stm[b * 36];
+            tidal_times_position_rows(&gradient[b * 9], phi, kick_new);
+            for (int k = 0; k < 18; k++) {
+                phi[18 + k] += 0.5 * (stm_kick_old[b * 18 + k] + kick_new[k]) * dt;
+            }
+        }
+    }
+
+    // Pair up bodies closer than regularization_radius and release pairs that
+    // separate beyond twice that (hysteresis avoids flickering at the boundary).
+    // Returns true if any pairing changed.
+    bool update_regularized_pairs() {
+        bool changed = false;
+        if (partner.size() != bodies.size()) {
+            changed = std::count_if(partner.begin(), partner.end(), [](int p) { return p >= 0; }) > 0;
+            partner.assign(bodies.size(), -1);
+        }
+        if (regularization_radius <= 0) {
+            for (auto& p : partner) {
+                if (p >= 0) changed = true;
+                p = -1;
+            }
+            return changed;
+        }
+
+        auto distance_sq = [this](size_t i, size_t j) {
+            double dx = bodies[j].x - bodies[i].x;
+            double dy = bodies[j].y - bodies[i].y;
+            double dz = bodies[j].z - bodies[i].z;
+            return dx*dx + dy*dy + dz*dz;
+        };
+
+        double release_sq = 4 * regularization_radius * regularization_radius;
+        for (size_t i = 0; i < bodies.size(); i++) {
+            int j = partner[i];
+            if (j > static_cast<int>(i) && distance_sq(i, j) > release_sq) {
+                partner[i] = -1;
+                partner[j] = -1;
+                changed = true;
+            }
+        }
+
+        double capture_sq = regularization_radius * regularization_radius;
+        for (size_t i = 0; i < bodies.size(); i++) {
+            if (partner[i] >= 0) continue;
+            int nearest = -1;
+            double nearest_sq = capture_sq;
+            for (size_t j = i + 1; j < bodies.size(); j++) {
+                if (partner[j] >= 0 || bodies[i].mass + bodies[j].mass <= 0) continue;
+                double r_sq = distance_sq(i, j);
+                if (r_sq < nearest_sq) {
+                    nearest = static_cast<int>(j);
+                    nearest_sq = r_sq;
+                }
+            }
+            if (nearest >= 0) {
+                partner[i] = nearest;
+                partner[nearest] = static_cast<int>(i);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    // Drift a regularized pair: centre of mass moves freely, relative motion
+    // follows the exact (KS-regularized) Kepler orbit
+    void drift_pair(int i, int j, double dt) {
+        CelestialBody& a = bodies[i];
+        CelestialBody& b = bodies[j];
+        double m = a.mass + b.mass;
+        double wa = a.mass / m;
+        double wb = b.mass / m;
+
+        double cx = wa * a.x + wb * b.x + (wa * a.vx + wb * b.vx) * dt;
+        double cy = wa * a.y + wb * b.y + (wa * a.vy + wb * b.vy) * dt;
+        double cz = wa * a.z + wb * b.z + (wa * a.vz + wb * b.vz) * dt;
+        double cvx = wa * a.vx + wb * b.vx;
+        double cvy = wa * a.vy + wb * b.vy;
+        double cvz = wa * a.vz + wb * b.vz;
+
+        double r[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+        double v[3] = {b.vx - a.vx, b.vy - a.vy, b.vz - a.vz};
+        ks_kepler_drift(r, v, GRAV * m, dt);
+
+        a.x = cx - wb * r[0]; a.y = cy - wb * r[1]; a.z = cz - wb * r[2];
+        b.x = cx + wa * r[0]; b.y = cy + wa * r[1]; b.z = cz + wa * r[2];
+        a.vx = cvx - wb * v[0]; a.vy = cvy - wb * v[1]; a.vz = cvz - wb * v[2];
+        b.vx = cvx + wa * v[0]; b.vy = cvy + wa * v[1]; b.vz = cvz + wa * v[2];
+    }
+
+    // Resolve parent_id (a body id) to an index into bodies; planets orbit the Sun
+    void rebuild_parent_index() {
+        std::unordered_map<int, int> index_of;
+        for (size_t i = 0; i < bodies.size(); i++) {
+            index_of[bodies[i].id] = static_cast<int>(i);
+        }
+        parent_index.assign(bodies.size(), -1);
+        for (size_t i = 1; i < bodies.size(); i++) {
+            auto it = index_of.find(bodies[i].parent_id);
+            parent_index[i] = (it != index_of.end()) ? it->second : 0;
+        }
+    }
+
+    // Compute derived quantities for the given bodies in one pass.
+    // Writes METRIC_COUNT values per index into out:
+    // [speed, distance_from_sun, distance_from_parent, orbital_period, kinetic_energy]
+    // Invalid indices yield zeros, matching the single-body getters.
+    void compute_body_metrics(const std::vector<int>& indices, double* out) const {
+        const size_t n = indices.size();
+        const int count = static_cast<int>(bodies.size());
+
+        // Gather into contiguous arrays so the arithmetic below vectorizes
+        std::vector<double> x(n, 0), y(n, 0), z(n, 0);
+        std::vector<double> vx(n, 0), vy(n, 0), vz(n, 0);
+        std::vector<double> px(n, 0), py(n, 0), pz(n, 0);
+        std::vector<double> mass(n, 0), valid(n, 0), orbits_sun(n, 0);
+        for (size_t k = 0; k < n; k++) {
+            int i = indices[k];
+            if (i < 0 || i >= count) continue;
+            const auto& body = bodies[i];
+            x[k] = body.x; y[k] = body.y; z[k] = body.z;
+            vx[k] = body.vx; vy[k] = body.vy; vz[k] = body.vz;
+            mass[k] = body.mass;
+            valid[k] = 1.0;
+            orbits_sun[k] = (i > 0) ? 1.0 : 0.0;
+            int p = parent_index[i];
+            if (p >= 0) {
+                px[k] = bodies[p].x; py[k] = bodies[p].y; pz[k] = bodies[p].z;
+            } else {
+                px[k] = body.x; py[k] = body.y; pz[k] = body.z;
+            }
+        }
+
+        // T = 2π * sqrt(r³ / (G*M_sun)), current r as approximation for a
+        const double inv_gm_sun = bodies.empty() ? 0.0 : 1.0 / (GRAV * bodies[0].mass);
+        for (size_t k = 0; k < n; k++) {
+            double v_sq = vx[k]*vx[k] + vy[k]*vy[k] + vz[k]*vz[k];
+            double r = std::sqrt(x[k]*x[k] + y[k]*y[k] + z[k]*z[k]);
+            double dx = x[k] - px[k];
+            double dy = y[k] - py[k];
+            double dz = z[k] - pz[k];
+            double* row = out + k * METRIC_COUNT;
+            row[0] = std::sqrt(v_sq) * valid[k];
+            row[1] = r * valid[k];
+            row[2] = std::sqrt(dx*dx + dy*dy + dz*dz);
+            row[3] = 2.0 * M_PI * std::sqrt(r*r*r * inv_gm_sun) * orbits_sun[k];
+            row[4] = 0.5 * mass[k] * v_sq;
+        }
+    }
+
+    // One metric column of compute_body_metrics for all bodies, computing
+    // only that quantity
+    std::vector<double> get_metric_column(int column) const {
+        const size_t n = bodies.size();
+        std::vector<double> result(n, 0.0);
+        auto speed_sq = [](const CelestialBody& b) { return b.vx*b.vx + b.vy*b.vy + b.vz*b.vz; };
+        auto sun_distance = [](const CelestialBody& b) { return std::sqrt(b.x*b.x + b.y*b.y + b.z*b.z); };
+        switch (column) {
+            case 0:
+                for (size_t i = 0; i < n; i++) result[i] = std::sqrt(speed_sq(bodies[i]));
+                break;
+            case 1:
+                for (size_t i = 0; i < n; i++) result[i] = sun_distance(bodies[i]);
+                break;
+            case 2:
+                for (size_t i = 0; i < n; i++) {
+                    int p = parent_index[i];
+                    if (p < 0) continue;
+                    double dx = bodies[i].x - bodies[p].x;
+                    double dy = bodies[i].y - bodies[p].y;
+                    double dz = bodies[i].z - bodies[p].z;
+                    result[i] = std::sqrt(dx*dx + dy*dy + dz*dz);
+                }
+                break;
+            case 3: {
+                const double inv_gm_sun = n == 0 ? 0.0 : 1.0 / (GRAV * bodies[0].mass);
+                for (size_t i = 1; i < n; i++) {
+                    double r = sun_distance(bodies[i]);
+                    result[i] = 2.0 * M_PI * std::sqrt(r*r*r * inv_gm_sun);
+                }
+                break;
+            }
+            case 4:
+                for (size_t i = 0; i < n; i++) result[i] = 0.5 * bodies[i].mass * speed_sq(bodies[i]);
+                break;
+        }
+        return result;
+    }
 
     // Compute gravitational acceleration on body i from all other bodies
-    void compute_acceleration(int i) {
+    // With WithGradient, also accumulates the 3x3 tidal tensor da_i/dx_i
+    // used by the variational equations, reusing the same pair distances.
+    // Unfused (reproducible mode) keeps every product out of FMA.
+    template <bool WithGradient, bool Unfused>
+    void compute_acceleration_impl(int i) {
         bodies[i].ax = 0;
         bodies[i].ay = 0;
         bodies[i].az = 0;
 
+        double* grad = WithGradient ? &gradient[i * 9] : nullptr;
+        if (WithGradient) std::fill(grad, grad + 9, 0.0);
+
+        // A regularized partner's pull is handled by the pair's Kepler drift
+        int skip = (static_cast<size_t>(i) < partner.size()) ? partner[i] : -1;
+
         for (size_t j = 0; j < bodies.size(); j++) {
             if (static_cast<int>(j) == i) continue;
+            if (!WithGradient && static_cast<int>(j) == skip) continue;
 
             double dx = bodies[j].x - bodies[i].x;
             double dy = bodies[j].y - bodies[i].y;
             double dz = bodies[j].z - bodies[i].z;
 
-            double r_sq = dx*dx + dy*dy + dz*dz;
+            double r_sq = product<Unfused>(dx, dx) + product<Unfused>(dy, dy) + product<Unfused>(dz, dz);
             double r = std::sqrt(r_sq);
             double r_cubed = r_sq * r;
 
             // a = GRAV * M / r² * (r_hat)
             double factor = GRAV * bodies[j].mass / r_cubed;
 
-            bodies[i].ax += factor * dx;
-            bodies[i].ay += factor * dy;
-            bodies[i].az += factor * dz;
+            if (WithGradient) {
+                // da/dx_i = GRAV * M / r³ * (3 r_hat r_hat^T - I)
+                double d[3] = {dx, dy, dz};
+                double scale = 3.0 / r_sq;
+                for (int row = 0; row < 3; row++) {
+                    for (int col = 0; col < 3; col++) {
+                        double term = product<Unfused>(scale * d[row], d[col]) - (row == col ? 1.0 : 0.0);
+                        grad[row * 3 + col] += product<Unfused>(factor, term);
+                    }
+                }
+                if (static_cast<int>(j) == skip) continue;
+            }
+
+            bodies[i].ax += product<Unfused>(factor, dx);
+            bodies[i].ay += product<Unfused>(factor, dy);
+            bodies[i].az += product<Unfused>(factor, dz);
+        }
+    }
+
+    void compute_acceleration(int i) {
+        if (variational_enabled) {
+            if (reproducible) compute_acceleration_impl<true, true>(i);
+            else compute_acceleration_impl<true, false>(i);
+        } else {
+            if (reproducible) compute_acceleration_impl<false, true>(i);
+            else compute_acceleration_impl<false, false>(i);
+        }
+    }
+
+    // ============================================================
+    // FORCE ENGINES
+    // ============================================================
+    static constexpr int TILE = 64;     // Bodies per block in the tiled engine
+    bool autotune;                      // Pick engine automatically
+    int force_engine;                   // Current ForceEngine
+    int engine_in_use;                  // Engine that ran last (-1: none since a setting changed)
+    int engine_threads;                 // Workers used by ENGINE_THREADED
+    int max_threads;                    // Upper bound for thread candidates
+    double force_error_bound;           // Accepted max relative force error vs direct
+    std::string autotune_cache_path;    // Decisions keyed by CPU and N bucket
+    int autotuned_bucket;               // N bucket of the last decision (-1: none)
+    std::unique_ptr<ForceThreadPool> pool;
+    bool thread_affinity;               // Pin pool workers across NUMA nodes
+    bool reproducible;                  // Fixed reduction order (see set_reproducible)
+    PageArray mirror_x, mirror_y, mirror_z, mirror_m;   // Threaded engine state, placed
+    PageArray mirror_ax, mirror_ay, mirror_az;          // by each row's worker (ensure_mirror)
+    size_t mirror_size;                 // Rows placed for the current pool (0: none)
+    std::vector<double> tile_x, tile_y, tile_z, tile_m, tile_ax, tile_ay, tile_az;
+
+    // Rendering
+    OrbitRasterizer rasterizer;
+    std::unique_ptr<ForceThreadPool> render_pool;
+    int framebuffer_views;              // Live Python views pinning the framebuffer size
+
+    // Multi-process tree engine
+    int worker_processes;               // Processes used by ENGINE_PROCESSES
+    double opening_angle;               // Barnes-Hut theta of ENGINE_PROCESSES
+    std::unique_ptr<DomainForceGroup> process_group;
+
+    // On-screen radius of a body in pixels, log-scaled from its physical radius
+    static double display_radius(const CelestialBody& body) {
+        if (body.radius <= 0) return 1.0;
+        return std::min(8.0, std::max(1.5, 1.5 + 1.5 * std::log10(body.radius / 1e6)));
+    }
+
+    void render_rows(bool trails, int row_begin, int row_end) {
+        rasterizer.fill_rows(row_begin, row_end, 0x000000);
+        if (trails) {
+            for (const auto& body : bodies) {
+                size_t n = body.trajectory_x.size();
+                double px = 0, py = 0;
+                for (size_t k = 0; k <= n; k++) {
+                    double wx = (k < n) ? body.trajectory_x[k] : body.x;
+                    double wy = (k < n) ? body.trajectory_y[k] : body.y;
+                    double sx = rasterizer.to_px(wx / AU);
+                    double sy = rasterizer.to_py(wy / AU);
+                    if (k > 0) rasterizer.draw_line(px, py, sx, sy, body.color, 0.3, row_begin, row_end);
+                    px = sx;
+                    py = sy;
+                }
+            }
+        }
+        for (const auto& body : bodies) {
+            rasterizer.draw_disc(rasterizer.to_px(body.x / AU), rasterizer.to_py(body.y / AU),
+                                 display_radius(body), body.color, row_begin, row_end);
+        }
+    }
+
+    bool is_partner(size_t i, size_t j) const {
+        return i < partner.size() && partner[i] == static_cast<int>(j);
+    }
+
+    void compute_pairwise() {
+        for (auto& body : bodies) {
+            body.ax = 0; body.ay = 0; body.az = 0;
+        }
+        for (size_t i = 0; i < bodies.size(); i++) {
+            CelestialBody& a = bodies[i];
+            for (size_t j = i + 1; j < bodies.size(); j++) {
+                if (is_partner(i, j)) continue;
+                CelestialBody& b = bodies[j];
+                double dx = b.x - a.x;
+                double dy = b.y - a.y;
+                double dz = b.z - a.z;
+                double r_sq = dx*dx + dy*dy + dz*dz;
+                double inv_r_cubed = 1.0 / (r_sq * std::sqrt(r_sq));
+                double fa = GRAV * b.mass * inv_r_cubed;
+                double fb = GRAV * a.mass * inv_r_cubed;
+                a.ax += fa * dx; a.ay += fa * dy; a.az += fa * dz;
+                b.ax -= fb * dx; b.ay -= fb * dy; b.az -= fb * dz;
+            }
+        }
+    }
+
+    void compute_tiled() {
+        const size_t n = bodies.size();
+        tile_x.resize(n); tile_y.resize(n); tile_z.resize(n); tile_m.resize(n);
+        tile_ax.assign(n, 0.0); tile_ay.assign(n, 0.0); tile_az.assign(n, 0.0);
+        for (size_t i = 0; i < n; i++) {
+            tile_x[i] = bodies[i].x; tile_y[i] = bodies[i].y; tile_z[i] = bodies[i].z;
+            tile_m[i] = GRAV * bodies[i].mass;
+        }
+
+        for (size_t bi = 0; bi < n; bi += TILE) {
+            size_t ei = std::min(n, bi + TILE);
+            for (size_t bj = bi; bj < n; bj += TILE) {
+                size_t ej = std::min(n, bj + TILE);
+                for (size_t i = bi; i < ei; i++) {
+                    double xi = tile_x[i], yi = tile_y[i], zi = tile_z[i], mi = tile_m[i];
+                    double axi = 0, ayi = 0, azi = 0;
+                    for (size_t j = std::max(bj, i + 1); j < ej; j++) {
+                        if (is_partner(i, j)) continue;
+                        double dx = tile_x[j] - xi;
+                        double dy = tile_y[j] - yi;
+                        double dz = tile_z[j] - zi;
+                        double r_sq = dx*dx + dy*dy + dz*dz;
+                        double inv_r_cubed = 1.0 / (r_sq * std::sqrt(r_sq));
+                        double fa = tile_m[j] * inv_r_cubed;
+                        double fb = mi * inv_r_cubed;
+                        axi += fa * dx; ayi += fa * dy; azi += fa * dz;
+                        tile_ax[j] -= fb * dx; tile_ay[j] -= fb * dy; tile_az[j] -= fb * dz;
+                    }
+                    tile_ax[i] += axi; tile_ay[i] += ayi; tile_az[i] += azi;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            bodies[i].ax = tile_ax[i]; bodies[i].ay = tile_ay[i]; bodies[i].az = tile_az[i];
+        }
+    }
+
+    // Create (or resize) a worker pool, pinned across NUMA nodes when enabled
+    void ensure_pool(std::unique_ptr<ForceThreadPool>& target, int threads) {
+        if (target && target->size() == threads) return;
+        std::vector<int> cpus;
+        if (thread_affinity) cpus = plan_worker_cpus(detect_cpu_topology(), threads);
+        target.reset(new ForceThreadPool(threads, cpus));
+        if (&target == &pool) mirror_size = 0;  // Rows changed owners
+    }
+
+    // SoA positions, masses and accelerations for the threaded engine. Each
+    // worker zero-fills its own rows (partition_rows) right after allocation,
+    // so with pinned workers a partition's pages sit on its worker's node and
+    // its reads of its own rows and all its writes stay local. Reads of other
+    // partitions' positions cannot be: every row needs all N positions.
+    // Worker 0, the caller, is not pinned; its rows land where it runs.
+    void ensure_mirror(size_t n) {
+        if (mirror_size == n) return;
+        for (PageArray* array : {&mirror_x, &mirror_y, &mirror_z, &mirror_m,
+                                 &mirror_ax, &mirror_ay, &mirror_az}) {
+            *array = make_page_array(n);
+        }
+        const int rows = static_cast<int>(n), threads = pool->size();
+        pool->run([this, rows, threads](int worker) {
+            int begin, end;
+            partition_rows(rows, threads, worker, begin, end);
+            for (PageArray* array : {&mirror_x, &mirror_y, &mirror_z, &mirror_m,
+                                     &mirror_ax, &mirror_ay, &mirror_az}) {
+                std::fill(array->get() + begin, array->get() + end, 0.0);
+            }
+        });
+        mirror_size = n;
+    }
+
+    void compute_threaded(int threads) {
+        ensure_pool(pool, threads);
+        const int n = static_cast<int>(bodies.size());
+
+        // The tidal tensor is only accumulated by the per-body kernel
+        if (variational_enabled) {
+            pool->run([this, n, threads](int worker) {
+                int begin, end;
+                partition_rows(n, threads, worker, begin, end);
+                for (int i = begin; i < end; i++) {
+                    compute_acceleration(i);
+                }
+            });
+            return;
+        }
+
+        ensure_mirror(bodies.size());
+        pool->run([this, n, threads](int worker) {
+            int begin, end;
+            partition_rows(n, threads, worker, begin, end);
+            for (int i = begin; i < end; i++) {
+                mirror_x[i] = bodies[i].x; mirror_y[i] = bodies[i].y; mirror_z[i] = bodies[i].z;
+                mirror_m[i] = bodies[i].mass;
+            }
+        });
+        pool->run([this, n, threads](int worker) {
+            int begin, end;
+            partition_rows(n, threads, worker, begin, end);
+            if (reproducible) threaded_rows<true>(n, begin, end);
+            else threaded_rows<false>(n, begin, end);
+            for (int i = begin; i < end; i++) {
+                bodies[i].ax = mirror_ax[i]; bodies[i].ay = mirror_ay[i]; bodies[i].az = mirror_az[i];
+            }
+        });
+    }
+
+    // Threaded engine rows [begin, end) from the mirror into mirror_ax/ay/az
+    template <bool Unfused>
+    void threaded_rows(int n, int begin, int end) {
+        const double* px = mirror_x.get();
+        const double* py = mirror_y.get();
+        const double* pz = mirror_z.get();
+        const double* pm = mirror_m.get();
+        for (int i = begin; i < end; i++) {
+            int skip = (static_cast<size_t>(i) < partner.size()) ? partner[i] : -1;
+            double ax = 0, ay = 0, az = 0;
+            // Same expression and j order as compute_acceleration
+            for (int j = 0; j < n; j++) {
+                if (j == i || j == skip) continue;
+                double dx = px[j] - px[i];
+                double dy = py[j] - py[i];
+                double dz = pz[j] - pz[i];
+                double r_sq = product<Unfused>(dx, dx) + product<Unfused>(dy, dy) + product<Unfused>(dz, dz);
+                double r = std::sqrt(r_sq);
+                double r_cubed = r_sq * r;
+                double factor = GRAV * pm[j] / r_cubed;
+                ax += product<Unfused>(factor, dx);
+                ay += product<Unfused>(factor, dy);
+                az += product<Unfused>(factor, dz);
+            }
+            mirror_ax[i] = ax; mirror_ay[i] = ay; mirror_az[i] = az;
+        }
+    }
+
+    // Run the Newtonian pass on the worker processes. Returns false if the
+    // workers could not be started or failed, in which case the caller falls
+    // back. A LET that outgrows the mapping re-forks the group with room for it.
+    bool compute_processes() {
+        const size_t n = bodies.size();
+        if (n == 0) return true;
+        size_t let_capacity = 0;
+        for (int attempt = 0; attempt < 3; attempt++) {
+            if (!process_group || process_group->size() != worker_processes
+                || process_group->capacity() < n || process_group->let_capacity() < let_capacity) {
+                process_group.reset();
+                pool.reset();           // Idle worker threads would block the fork
+                render_pool.reset();
+                const size_t capacity = std::max<size_t>(n + n / 2, 1024);
+                const size_t domain = DomainForceGroup::largest_domain(worker_processes, capacity);
+                // Far domains receive few entries; start at an eighth of the bound
+                process_group.reset(new DomainForceGroup(worker_processes, capacity,
+                                                         std::max({let_capacity, domain / 8, size_t(64)})));
+            }
+            if (!process_group->ok()) {
+                process_group.reset();
+                return false;
+            }
+
+            DomainForceGroup& group = *process_group;
+            group.decompose(bodies);
+            size_t needed = 0;
+            if (!group.compute(opening_angle, needed)) {
+                if (needed == 0) {
+                    process_group.reset();
+                    return false;
+                }
+                let_capacity = needed + needed / 2;
+                continue;
+            }
+            for (size_t k = 0; k < n; k++) {
+                CelestialBody& body = bodies[group.id[k]];
+                body.ax = group.ax[k]; body.ay = group.ay[k]; body.az = group.az[k];
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool has_regularized_pairs() const {
+        return std::any_of(partner.begin(), partner.end(), [](int p) { return p >= 0; });
+    }
+
+    // Engine that runs when the given one is requested under the current modes
+    int resolve_engine(int engine) const {
+        // Only the threaded engine sums each body's forces in a fixed order and
+        // accumulates the variational tidal tensor
+        if ((reproducible || variational_enabled) && engine != ENGINE_THREADED) {
+            return ENGINE_DIRECT;
+        }
+        // The tree cells do not leave out a regularized partner
+        if (engine == ENGINE_PROCESSES && has_regularized_pairs()) return ENGINE_DIRECT;
+        return engine;
+    }
+
+    // Newtonian point-mass accelerations with the given engine
+    void compute_newtonian(int engine, int threads) {
+        engine = resolve_engine(engine);
+        engine_in_use = engine;
+        switch (engine) {
+            case ENGINE_PAIRWISE: compute_pairwise(); break;
+            case ENGINE_TILED: compute_tiled(); break;
+            case ENGINE_THREADED: compute_threaded(threads); break;
+            case ENGINE_PROCESSES:
+                if (compute_processes()) break;
+                engine_in_use = ENGINE_DIRECT;
+                for (size_t i = 0; i < bodies.size(); i++) {
+                    compute_acceleration(i);
+                }
+                break;
+            default:
+                for (size_t i = 0; i < bodies.size(); i++) {
+                    compute_acceleration(i);
+                }
         }
     }
 
     // Compute all accelerations
     void compute_all_accelerations() {
+        compute_newtonian(force_engine, engine_threads);
+        // Perturbations selected at compile time; an empty pack adds nothing
+        (ForceTerms::apply(bodies), ...);
+    }
+
+    // Bodies are bucketed by powers of two; a new bucket triggers re-tuning
+    int body_count_bucket() const {
+        int bucket = 0;
+        for (size_t n = bodies.size(); n > 1; n >>= 1) bucket++;
+        return bucket;
+    }
+
+    std::string autotune_key() const {
+        return cpu_signature() + "\t" + std::to_string(body_count_bucket()) + "\t"
+               + (variational_enabled ? "var" : "plain") + (reproducible ? "-repro" : "") + "\t"
+               + std::to_string(max_threads);
+    }
+
+    bool load_autotune_decision(const std::string& key) {
+        std::ifstream in(autotune_cache_path);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t split = line.rfind('\t');
+            if (split == std::string::npos) continue;
+            size_t split2 = line.rfind('\t', split - 1);
+            if (split2 == std::string::npos || line.substr(0, split2) != key) continue;
+            force_engine = std::atoi(line.c_str() + split2 + 1);
+            engine_threads = std::max(1, std::atoi(line.c_str() + split + 1));
+            return force_engine >= 0 && force_engine < ENGINE_COUNT && force_engine != ENGINE_PROCESSES;
+        }
+        return false;
+    }
+
+    void store_autotune_decision(const std::string& key) {
+        std::vector<std::string> kept;
+        {
+            std::ifstream in(autotune_cache_path);
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.compare(0, key.size() + 1, key + "\t") != 0) {
+                    kept.push_back(line);
+                }
+            }
+        }
+        // Written next to the cache and renamed over it like save_checkpoint,
+        // so a crash mid-write never leaves a truncated cache
+        std::error_code ignored;
+        std::filesystem::create_directories(std::filesystem::path(autotune_cache_path).parent_path(), ignored);
+        const std::string temporary = autotune_cache_path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            for (const auto& line : kept) out << line << "\n";
+            out << key << "\t" << force_engine << "\t" << engine_threads << "\n";
+            if (!out.flush()) {
+                out.close();
+                std::remove(temporary.c_str());
+                return;
+            }
+        }
+        if (std::rename(temporary.c_str(), autotune_cache_path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+        }
+    }
+
+    // Micro-benchmark each engine and thread count on the current bodies and
+    // keep the fastest one whose forces match the direct engine within the bound
+    void run_autotune() {
+        const size_t n = bodies.size();
+        compute_newtonian(ENGINE_DIRECT, 1);
+        std::vector<double> reference(n * 3);
+        for (size_t i = 0; i < n; i++) {
+            reference[i*3] = bodies[i].ax; reference[i*3+1] = bodies[i].ay; reference[i*3+2] = bodies[i].az;
+        }
+
+        std::vector<std::pair<int, int>> candidates = {{ENGINE_DIRECT, 1}};
+        if (!reproducible) {
+            candidates.push_back({ENGINE_PAIRWISE, 1});
+            candidates.push_back({ENGINE_TILED, 1});
+        }
+        for (int t = 2; t <= max_threads; t *= 2) {
+            candidates.push_back({ENGINE_THREADED, t});
+        }
+        if (max_threads > 1 && (max_threads & (max_threads - 1)) != 0) {
+            candidates.push_back({ENGINE_THREADED, max_threads});
+        }
+
+        // Repeat enough to time at least ~2M pair interactions per candidate
+        int repeats = static_cast<int>(std::max<size_t>(3, std::min<size_t>(1000, 2000000 / (n * n + 1))));
+        double best_time = 0;
+        int best_engine = ENGINE_DIRECT, best_threads = 1;
+        for (const auto& candidate : candidates) {
+            compute_newtonian(candidate.first, candidate.second);  // Warm-up
+            double error = 0;
+            for (size_t i = 0; i < n; i++) {
+                double ex = bodies[i].ax - reference[i*3];
+                double ey = bodies[i].ay - reference[i*3+1];
+                double ez = bodies[i].az - reference[i*3+2];
+                double ref = std::sqrt(reference[i*3]*reference[i*3] + reference[i*3+1]*reference[i*3+1]
+                                       + reference[i*3+2]*reference[i*3+2]);
+                if (ref > 0) error = std::max(error, std::sqrt(ex*ex + ey*ey + ez*ez) / ref);
+            }
+            if (error > force_error_bound) continue;
+
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeats; r++) {
+                compute_newtonian(candidate.first, candidate.second);
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (best_time == 0 || elapsed < best_time) {
+                best_time = elapsed;
+                best_engine = candidate.first;
+                best_threads = candidate.second;
+            }
+        }
+
+        force_engine = best_engine;
+        engine_threads = best_threads;
+        if (force_engine != ENGINE_THREADED) pool.reset();
+    }
+
+    // Choose an engine when autotuning and the N bucket changed since the last choice
+    void maybe_autotune() {
+        if (!autotune || bodies.empty() || body_count_bucket() == autotuned_bucket) return;
+        std::string key = autotune_key();
+        if (autotune_cache_path.empty() || !load_autotune_decision(key)) {
+            // The benchmark overwrites the forces of the current state; keep
+            // them rather than paying for another evaluation afterwards
+            std::vector<double> saved(bodies.size() * 3);
+            for (size_t i = 0; i < bodies.size(); i++) {
+                saved[i*3] = bodies[i].ax; saved[i*3+1] = bodies[i].ay; saved[i*3+2] = bodies[i].az;
+            }
+            std::vector<double> saved_gradient = gradient;
+            run_autotune();
+            for (size_t i = 0; i < bodies.size(); i++) {
+                bodies[i].ax = saved[i*3]; bodies[i].ay = saved[i*3+1]; bodies[i].az = saved[i*3+2];
+            }
+            gradient.swap(saved_gradient);
+            if (!autotune_cache_path.empty()) store_autotune_decision(key);
+        }
+        autotuned_bucket = body_count_bucket();
+    }
+
+    // Write the checkpoint text to path; false if any write failed
+    bool write_checkpoint(const std::string& path) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+        out.precision(17);
+        out << "solar_system_checkpoint 3\n";
+        out << simulation_time << " " << step_count << " " << initial_energy << " " << bodies.size() << "\n";
+        for (const auto& b : bodies) {
+            out << b.id << " " << b.parent_id << " " << b.mass << " " << b.radius << " "
+                << b.obliquity << " " << b.rotation_period << " " << b.j2 << " "
+                << b.area_to_mass << " " << b.reflectivity << " "
+                << b.x << " " << b.y << " " << b.z << " " << b.vx << " " << b.vy << " " << b.vz << " "
+                << b.ax << " " << b.ay << " " << b.az << " "
+                << b.semi_major_axis << " " << b.eccentricity << " " << b.inclination << " "
+                << b.orbital_period << " " << b.trajectory_max_points << " " << b.color << " "
+                << b.name << "\n";
+        }
+        // Version 3: KS pairing (its capture/release hysteresis is not
+        // recoverable from positions) and the variational state
+        out << "partners";
         for (size_t i = 0; i < bodies.size(); i++) {
-            compute_acceleration(i);
+            out << " " << (i < partner.size() ? partner[i] : -1);
         }
+        out << "\nvariational " << (variational_enabled ? 1 : 0) << "\n";
+        if (variational_enabled) {
+            for (double value : stm) out << value << " ";
+            for (double value : gradient) out << value << " ";
+            out << "\n";
+        }
+        out.close();    // Flushes; a failed flush sets failbit
+        return !out.fail();
     }
 
 public:
-    SolarSystem() : simulation_time(0), total_energy(0), initial_energy(0), step_count(0) {}
+    // Values per body returned by get_body_metrics
+    static constexpr int METRIC_COUNT = 5;
+
+    BasicSolarSystem() : simulation_time(0), total_energy(0), initial_energy(0), step_count(0),
+                         regularization_radius(0), variational_enabled(false),
+                         autotune(false), force_engine(ENGINE_DIRECT), engine_in_use(-1), engine_threads(1),
+                         max_threads(std::max(1u, std::thread::hardware_concurrency())),
+                         force_error_bound(1e-12), autotune_cache_path(default_autotune_cache_path()),
+                         autotuned_bucket(-1), thread_affinity(false), reproducible(false),
+                         mirror_size(0), framebuffer_views(0), worker_processes(max_threads),
+                         opening_angle(0.5) {}
 
     // Initialize with real solar system data (J2000.0 epoch)
     void init_real_solar_system() {
@@ -132,11 +2066,13 @@ public:
         // ============================================================
         CelestialBody sun;
         sun.name = "Sun";
+        sun.color = 0xFFD700;
         sun.id = 0;
         sun.parent_id = -1;
         sun.mass = 1.98892e30;
         sun.radius = 6.96340e8;
         sun.obliquity = 7.25 * M_PI / 180.0;
+        sun.j2 = 2.2e-7;
         sun.rotation_period = 25.38 * DAY;
         sun.x = 0; sun.y = 0; sun.z = 0;
         sun.vx = 0; sun.vy = 0; sun.vz = 0;
@@ -148,11 +2084,13 @@ public:
         // ============================================================
         CelestialBody mercury;
         mercury.name = "Mercury";
+        mercury.color = 0xB5B5B5;
         mercury.id = 1;
         mercury.parent_id = -1;
         mercury.mass = 3.30114e23;
         mercury.radius = 2.4397e6;
         mercury.obliquity = 0.034 * M_PI / 180.0;
+        mercury.j2 = 5.03e-5;
         mercury.rotation_period = 58.646 * DAY;
         mercury.semi_major_axis = 0.387098 * AU;
         mercury.eccentricity = 0.205630;
@@ -175,11 +2113,13 @@ public:
         // ============================================================
         CelestialBody venus;
         venus.name = "Venus";
+        venus.color = 0xE6C35C;
         venus.id = 2;
         venus.parent_id = -1;
         venus.mass = 4.86747e24;
         venus.radius = 6.0518e6;
         venus.obliquity = 177.36 * M_PI / 180.0;  // Retrograde rotation!
+        venus.j2 = 4.458e-6;
         venus.rotation_period = -243.025 * DAY;    // Negative = retrograde
         venus.semi_major_axis = 0.723332 * AU;
         venus.eccentricity = 0.006772;
@@ -200,11 +2140,13 @@ public:
         // ============================================================
         CelestialBody earth;
         earth.name = "Earth";
+        earth.color = 0x4169E1;
         earth.id = 3;
         earth.parent_id = -1;
         earth.mass = 5.97237e24;
         earth.radius = 6.371e6;
         earth.obliquity = 23.4393 * M_PI / 180.0;
+        earth.j2 = 1.08263e-3;
         earth.rotation_period = 0.99726968 * DAY;
         earth.semi_major_axis = 1.000001018 * AU;
         earth.eccentricity = 0.0167086;
@@ -225,11 +2167,13 @@ public:
         // ============================================================
         CelestialBody moon;
         moon.name = "Moon";
+        moon.color = 0xC0C0C0;
         moon.id = 31;
         moon.parent_id = 3;  // Earth
         moon.mass = 7.342e22;
         moon.radius = 1.7371e6;
         moon.obliquity = 6.687 * M_PI / 180.0;
+        moon.j2 = 2.033e-4;
         moon.rotation_period = 27.321661 * DAY;  // Tidally locked
         moon.semi_major_axis = 3.84399e8;  // From Earth
         moon.eccentricity = 0.0549;
@@ -252,11 +2196,13 @@ public:
         // ============================================================
         CelestialBody mars;
         mars.name = "Mars";
+        mars.color = 0xCD5C5C;
         mars.id = 4;
         mars.parent_id = -1;
         mars.mass = 6.41712e23;
         mars.radius = 3.3895e6;
         mars.obliquity = 25.19 * M_PI / 180.0;
+        mars.j2 = 1.96045e-3;
         mars.rotation_period = 1.025957 * DAY;
         mars.semi_major_axis = 1.523679 * AU;
         mars.eccentricity = 0.0934;
@@ -277,11 +2223,13 @@ public:
         // ============================================================
         CelestialBody jupiter;
         jupiter.name = "Jupiter";
+        jupiter.color = 0xDEB887;
         jupiter.id = 5;
         jupiter.parent_id = -1;
         jupiter.mass = 1.89819e27;
         jupiter.radius = 6.9911e7;
         jupiter.obliquity = 3.13 * M_PI / 180.0;
+        jupiter.j2 = 1.4736e-2;
         jupiter.rotation_period = 0.41354 * DAY;
         jupiter.semi_major_axis = 5.2044 * AU;
         jupiter.eccentricity = 0.0489;
@@ -304,6 +2252,7 @@ public:
         // IO
         CelestialBody io;
         io.name = "Io";
+        io.color = 0xFFFF00;
         io.id = 51;
         io.parent_id = 5;
         io.mass = 8.9319e22;
@@ -325,6 +2274,7 @@ public:
         // EUROPA
         CelestialBody europa;
         europa.name = "Europa";
+        europa.color = 0xF5DEB3;
         europa.id = 52;
         europa.parent_id = 5;
         europa.mass = 4.7998e22;
@@ -346,6 +2296,7 @@ public:
         // GANYMEDE
         CelestialBody ganymede;
         ganymede.name = "Ganymede";
+        ganymede.color = 0xA9A9A9;
         ganymede.id = 53;
         ganymede.parent_id = 5;
         ganymede.mass = 1.4819e23;
@@ -367,6 +2318,7 @@ public:
         // CALLISTO
         CelestialBody callisto;
         callisto.name = "Callisto";
+        callisto.color = 0x696969;
         callisto.id = 54;
         callisto.parent_id = 5;
         callisto.mass = 1.0759e23;
@@ -390,11 +2342,13 @@ public:
         // ============================================================
         CelestialBody saturn;
         saturn.name = "Saturn";
+        saturn.color = 0xF4D03F;
         saturn.id = 6;
         saturn.parent_id = -1;
         saturn.mass = 5.6834e26;
         saturn.radius = 5.8232e7;
         saturn.obliquity = 26.73 * M_PI / 180.0;
+        saturn.j2 = 1.6298e-2;
         saturn.rotation_period = 0.444 * DAY;
         saturn.semi_major_axis = 9.5826 * AU;
         saturn.eccentricity = 0.0565;
@@ -413,6 +2367,7 @@ public:
         // TITAN
         CelestialBody titan;
         titan.name = "Titan";
+        titan.color = 0xDAA520;
         titan.id = 61;
         titan.parent_id = 6;
         titan.mass = 1.3452e23;
@@ -436,11 +2391,13 @@ public:
         // ============================================================
         CelestialBody uranus;
         uranus.name = "Uranus";
+        uranus.color = 0x87CEEB;
         uranus.id = 7;
         uranus.parent_id = -1;
         uranus.mass = 8.6810e25;
         uranus.radius = 2.5362e7;
         uranus.obliquity = 97.77 * M_PI / 180.0;  // Extreme tilt!
+        uranus.j2 = 3.343e-3;
         uranus.rotation_period = -0.71833 * DAY;   // Retrograde
         uranus.semi_major_axis = 19.19126 * AU;
         uranus.eccentricity = 0.04717;
@@ -461,11 +2418,13 @@ public:
         // ============================================================
         CelestialBody neptune;
         neptune.name = "Neptune";
+        neptune.color = 0x1E90FF;
         neptune.id = 8;
         neptune.parent_id = -1;
         neptune.mass = 1.02413e26;
         neptune.radius = 2.4622e7;
         neptune.obliquity = 28.32 * M_PI / 180.0;
+        neptune.j2 = 3.411e-3;
         neptune.rotation_period = 0.6713 * DAY;
         neptune.semi_major_axis = 30.07 * AU;
         neptune.eccentricity = 0.008678;
@@ -484,6 +2443,7 @@ public:
         // TRITON (retrograde orbit!)
         CelestialBody triton;
         triton.name = "Triton";
+        triton.color = 0xADD8E6;
         triton.id = 81;
         triton.parent_id = 8;
         triton.mass = 2.139e22;
@@ -507,6 +2467,7 @@ public:
         // ============================================================
         CelestialBody pluto;
         pluto.name = "Pluto";
+        pluto.color = 0xD2B48C;
         pluto.id = 9;
         pluto.parent_id = -1;
         pluto.mass = 1.303e22;
@@ -529,6 +2490,11 @@ public:
         pluto.vz = v_pluto * std::cos(pluto_angle) * std::sin(pluto.inclination);
         pluto.trajectory_max_points = 2000;
         bodies.push_back(pluto);
+        rebuild_parent_index();
+        partner.assign(bodies.size(), -1);
+        if (variational_enabled) {
+            reset_stm();
+        }
 
         // Initialize accelerations
         compute_all_accelerations();
@@ -543,8 +2509,390 @@ public:
         total_energy = initial_energy;
     }
 
+    // Write the full simulation state to a text checkpoint. Trajectory history
+    // is not included. The state goes to path + ".tmp" and is renamed over
+    // path only once complete, so a crash never leaves a truncated checkpoint.
+    // Returns false (keeping any previous checkpoint) if the write fails.
+    bool save_checkpoint(const std::string& path) {
+        const std::string temporary = path + ".tmp";
+        if (!write_checkpoint(temporary) || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Restore a state written by save_checkpoint. Older versions lack
+    // accelerations (1), KS pairs and state-transition matrices (1 and 2);
+    // those are recomputed, pairs re-captured and matrices restarted. Returns
+    // false (leaving the system unchanged) if the file is missing or malformed.
+    bool load_checkpoint(const std::string& path) {
+        std::ifstream in(path);
+        std::string magic;
+        int version = 0;
+        if (!(in >> magic >> version) || magic != "solar_system_checkpoint" || version < 1 || version > 3) {
+            return false;
+        }
+
+        double time, energy;
+        int steps;
+        size_t count;
+        if (!(in >> time >> steps >> energy >> count)) return false;
+
+        // A body line holds at least 21 fields of two characters; reject a
+        // count the rest of the file cannot hold before allocating for it
+        const std::streampos here = in.tellg();
+        in.seekg(0, std::ios::end);
+        const std::streamoff remaining = in.tellg() - here;
+        in.seekg(here);
+        if (remaining < 0 || count > static_cast<size_t>(remaining) / 42) return false;
+
+        std::vector<CelestialBody> loaded(count);
+        std::vector<double> accelerations;
+        for (auto& b : loaded) {
+            if (!(in >> b.id >> b.parent_id >> b.mass >> b.radius >> b.obliquity >> b.rotation_period
+                     >> b.j2 >> b.area_to_mass >> b.reflectivity
+                     >> b.x >> b.y >> b.z >> b.vx >> b.vy >> b.vz)
+                || (version >= 2 && !(in >> b.ax >> b.ay >> b.az))
+                || !(in >> b.semi_major_axis >> b.eccentricity >> b.inclination >> b.orbital_period
+                     >> b.trajectory_max_points >> b.color)) {
+                return false;
+            }
+            in.get();
+            std::getline(in, b.name);
+            accelerations.insert(accelerations.end(), {b.ax, b.ay, b.az});
+        }
+
+        std::vector<int> pairs(count, -1);
+        std::vector<double> saved_stm, saved_gradient;
+        if (version >= 3) {
+            std::string label;
+            if (!(in >> label) || label != "partners") return false;
+            for (auto& p : pairs) {
+                if (!(in >> p) || p < -1 || p >= static_cast<int>(count)) return false;
+            }
+            int has_stm = 0;
+            if (!(in >> label >> has_stm) || label != "variational") return false;
+            for (size_t i = 0; i < count; i++) {
+                const int p = pairs[i];
+                if (p >= 0 && (p == static_cast<int>(i) || pairs[p] != static_cast<int>(i))) return false;
+            }
+            if (has_stm) {
+                saved_stm.resize(count * 36);
+                saved_gradient.resize(count * 9);
+                for (auto& value : saved_stm) if (!(in >> value)) return false;
+                for (auto& value : saved_gradient) if (!(in >> value)) return false;
+            }
+        }
+
+        bodies = std::move(loaded);
+        simulation_time = time;
+        step_count = steps;
+        rebuild_parent_index();
+        partner = std::move(pairs);
+        if (variational_enabled) {
+            reset_stm();
+        }
+        compute_all_accelerations();
+        if (variational_enabled && !saved_stm.empty()) {
+            stm = std::move(saved_stm);
+            gradient = std::move(saved_gradient);
+        }
+        // Version 2 keeps a(t) as the last step computed it. Velocity-dependent
+        // terms saw the predicted velocity there, so recomputing from v(t)
+        // would make a resumed run drift from an uninterrupted one.
+        for (size_t i = 0; i < bodies.size(); i++) {
+            auto& body = bodies[i];
+            if (version >= 2) {
+                body.ax = accelerations[i*3];
+                body.ay = accelerations[i*3 + 1];
+                body.az = accelerations[i*3 + 2];
+            }
+            body.ax_old = body.ax;
+            body.ay_old = body.ay;
+            body.az_old = body.az;
+        }
+        initial_energy = energy;
+        total_energy = calculate_total_energy();
+        return true;
+    }
+
+    // Regularize pairs closer than radius [m] with KS variables; 0 disables
+    void set_regularization_radius(double radius) {
+        regularization_radius = radius;
+    }
+
+    double get_regularization_radius() { return regularization_radius; }
+
+    // Number of currently regularized pairs
+    int get_regularized_pair_count() {
+        int count = 0;
+        for (size_t i = 0; i < partner.size(); i++) {
+            if (partner[i] > static_cast<int>(i)) count++;
+        }
+        return count;
+    }
+
+    // Integrate the variational equations alongside step(); enabling resets
+    // every state-transition matrix to identity at the current state
+    void set_variational(bool enabled) {
+        variational_enabled = enabled;
+        engine_in_use = -1;
+        if (enabled) {
+            reset_state_transition_matrices();
+        }
+    }
+
+    bool get_variational() { return variational_enabled; }
+
+    // Restart the state-transition matrices from the current state
+    void reset_state_transition_matrices() {
+        reset_stm();
+        if (variational_enabled) {
+            compute_all_accelerations();
+        }
+    }
+
+    // 6x6 state-transition matrix of a body, row-major over (x, y, z, vx, vy, vz)
+    std::vector<double> get_state_transition_matrix(int body_index) {
+        if (!variational_enabled || body_index < 0 || body_index >= static_cast<int>(bodies.size())) {
+            return {};
+        }
+        return std::vector<double>(stm.begin() + body_index * 36, stm.begin() + (body_index + 1) * 36);
+    }
+
+    // Select the Newtonian force engine: "direct", "pairwise", "tiled",
+    // "threaded", "processes" (see set_num_processes) or "auto" (benchmark
+    // on the first step and after N changes bucket; never picks "processes").
+    // Throws std::invalid_argument for any other name.
+    void set_force_engine(const std::string& name) {
+        if (name == "auto") {
+            autotune = true;
+            autotuned_bucket = -1;
+            engine_in_use = -1;
+            return;
+        }
+        for (int engine = 0; engine < ENGINE_COUNT; engine++) {
+            if (name == force_engine_name(engine)) {
+                autotune = false;
+                force_engine = engine;
+                engine_in_use = -1;
+                engine_threads = (engine == ENGINE_THREADED) ? max_threads : 1;
+                if (engine != ENGINE_PROCESSES) process_group.reset();
+                return;
+            }
+        }
+        throw std::invalid_argument("set_force_engine: unknown engine '" + name + "'");
+    }
+
+    // Engine that computed the last forces: the autotuner's pick in "auto"
+    // mode, or "direct" when reproducible or variational mode, regularized
+    // pairs or a failed fork overrode the selection. Before the next step,
+    // the engine it will use.
+    std::string get_force_engine() {
+        return force_engine_name(engine_in_use >= 0 ? engine_in_use : resolve_engine(force_engine));
+    }
+
+    // Number of worker processes for the "processes" engine. Forked workers
+    // are not benchmarked by the autotuner; select the engine explicitly.
+    // Workers are forked only while no other thread runs in the process (a
+    // Python interpreter with live threads included, see DomainForceGroup);
+    // otherwise forces are computed directly and "threaded" is the better pick.
+    void set_num_processes(int processes) {
+        worker_processes = std::max(1, processes);
+    }
+
+    int get_num_processes() { return worker_processes; }
+
+    // Opening angle theta of the "processes" engine (default 0.5). Cells
+    // smaller than theta times their distance act as point masses; the force
+    // error grows roughly as theta squared, and 0 sums every pair.
+    void set_opening_angle(double theta) {
+        opening_angle = std::max(0.0, theta);
+    }
+
+    double get_opening_angle() { return opening_angle; }
+
+    // Thread count of the threaded engine and cap for autotune candidates
+    void set_num_threads(int threads) {
+        max_threads = std::max(1, threads);
+        if (force_engine == ENGINE_THREADED && !autotune) engine_threads = max_threads;
+        autotuned_bucket = -1;
+    }
+
+    int get_num_threads() { return max_threads; }
+
+    // Pin worker threads (w > 0) of the force and render pools to CPUs,
+    // spreading contiguous workers over NUMA nodes. This keeps workers on
+    // their caches and balances them across sockets. Worker 0 is the calling
+    // thread, which stays where the caller's scheduler put it. The threaded
+    // engine's arrays are re-placed by the new workers (see ensure_mirror).
+    // For ensembles, pin whole members instead (see run_ensemble).
+    void set_thread_affinity(bool enabled) {
+        thread_affinity = enabled;
+        pool.reset();
+        render_pool.reset();
+    }
+
+    bool get_thread_affinity() { return thread_affinity; }
+
+    // Human-readable NUMA layout and the CPU planned for each worker; worker
+    // 0, the calling thread, is listed as "caller" since it is never pinned
+    std::string get_cpu_topology() {
+        CpuTopology topology = detect_cpu_topology();
+        std::ostringstream report;
+        for (size_t node = 0; node < topology.nodes.size(); node++) {
+            report << "node " << node << ": " << topology.nodes[node].size() << " cpus [";
+            for (size_t k = 0; k < topology.nodes[node].size(); k++) {
+                report << (k ? "," : "") << topology.nodes[node][k];
+            }
+            report << "]\n";
+        }
+        std::vector<int> cpus = plan_worker_cpus(topology, max_threads);
+        report << "workers (" << max_threads << "): caller";
+        for (size_t w = 1; w < cpus.size(); w++) report << " " << cpus[w];
+        if (cpus.size() > 1) report << (thread_affinity ? " (pinned)" : " (not pinned)");
+        report << "\n";
+        return report.str();
+    }
+
+    // Bit-reproducible mode: results are identical for every thread count.
+    // Forces use only the row-wise engines (direct or threaded), which sum each
+    // body's pulls in fixed index order; energy rows are combined with a fixed
+    // pairwise tree. Cost: the pairwise and tiled engines, which evaluate each
+    // pair once, are unavailable, so the Newtonian pass does up to twice the
+    // work on a single thread, and the force, energy and Verlet update
+    // products are kept out of fused multiply-adds (unfused_mul), so builds
+    // with and without FMA (-march, -ffp-contract) agree as well. KS drifts
+    // and variational propagation keep the build's contraction setting. A
+    // build with -ffast-math would still let the compiler reorder the sums
+    // and must be avoided.
+    void set_reproducible(bool enabled) {
+        reproducible = enabled;
+        autotuned_bucket = -1;
+        engine_in_use = -1;
+    }
+
+    bool get_reproducible() { return reproducible; }
+
+    // Max relative force error vs the direct engine the autotuner accepts
+    void set_force_error_bound(double bound) {
+        force_error_bound = bound;
+        autotuned_bucket = -1;
+    }
+
+    // File caching autotune decisions, by default the per-user one from
+    // default_autotune_cache_path(); empty disables the cache
+    void set_autotune_cache(const std::string& path) {
+        autotune_cache_path = path;
+    }
+
+    // Framebuffer size in pixels for render(). Throws std::runtime_error
+    // when a framebuffer view is alive and the size would change.
+    void set_render_size(int width, int height) {
+        if (framebuffer_views > 0 && (std::max(1, width) != rasterizer.get_width()
+                                      || std::max(1, height) != rasterizer.get_height())) {
+            throw std::runtime_error("set_render_size: cannot resize while framebuffer views are alive");
+        }
+        rasterizer.resize(width, height);
+    }
+
+    // View centred on (center_x, center_y) AU showing ±half_width AU horizontally
+    void set_camera(double center_x, double center_y, double half_width) {
+        rasterizer.set_camera(center_x, center_y, half_width);
+    }
+
+    // Rasterize bodies (and trajectories if trails) into the RGBA framebuffer
+    // using up to threads horizontal bands
+    void render(bool trails, int threads) {
+        if (rasterizer.get_width() == 0) set_render_size(800, 800);
+        threads = std::max(1, std::min(threads, rasterizer.get_height()));
+        ensure_pool(render_pool, threads);
+        const int height = rasterizer.get_height();
+        render_pool->run([this, trails, threads, height](int worker) {
+            render_rows(trails, height * worker / threads, height * (worker + 1) / threads);
+        });
+    }
+
+#ifdef SOLAR_SYSTEM_PYTHON
+    // Writable (height, width, 4) RGBA8 memoryview of the framebuffer for
+    // owner, the Python object of this system (get_framebuffer_view in the
+    // bound classes). The view holds owner, so the system outlives it, and
+    // pins the framebuffer size until the view is released. NumPy reads it
+    // without copying: img = np.asarray(system.get_framebuffer_view())
+    pybind11::memoryview framebuffer_view_for(pybind11::object owner) {
+        if (rasterizer.get_width() == 0) set_render_size(800, 800);
+        struct Pin {
+            pybind11::object owner;
+            int* views;
+        };
+        pybind11::capsule base(new Pin{std::move(owner), &framebuffer_views}, [](void* pointer) {
+            Pin* pin = static_cast<Pin*>(pointer);
+            --*pin->views;
+            delete pin;
+        });
+        framebuffer_views++;
+        const pybind11::ssize_t width = rasterizer.get_width(), height = rasterizer.get_height();
+        pybind11::array_t<uint8_t> pixels({height, width, pybind11::ssize_t(4)},
+                                          {width * 4, pybind11::ssize_t(4), pybind11::ssize_t(1)},
+                                          rasterizer.data(), base);
+        return pybind11::memoryview(pixels);
+    }
+#endif
+
+    int get_framebuffer_size() { return static_cast<int>(rasterizer.byte_size()); }
+    int get_render_width() { return rasterizer.get_width(); }
+    int get_render_height() { return rasterizer.get_height(); }
+
+    // Copy of the framebuffer, for callers that cannot hold a view
+    std::vector<uint8_t> get_framebuffer() {
+        return std::vector<uint8_t>(rasterizer.data(), rasterizer.data() + rasterizer.byte_size());
+    }
+
+    // Add a massless test particle (heliocentric state, SI units).
+    // area_to_mass > 0 makes it subject to SolarRadiationPressure when enabled.
+    void add_test_particle(double x, double y, double z,
+                           double vx, double vy, double vz, double area_to_mass) {
+        CelestialBody particle;
+        particle.name = "Particle " + std::to_string(bodies.size());
+        particle.id = 0;
+        for (const auto& body : bodies) {
+            particle.id = std::max(particle.id, body.id + 1);
+        }
+        particle.parent_id = -1;
+        particle.x = x; particle.y = y; particle.z = z;
+        particle.vx = vx; particle.vy = vy; particle.vz = vz;
+        particle.area_to_mass = area_to_mass;
+        particle.trajectory_max_points = 500;
+        bodies.push_back(particle);
+        rebuild_parent_index();
+        partner.push_back(-1);
+        if (variational_enabled) {
+            stm.resize(bodies.size() * 36, 0.0);
+            for (int k = 0; k < 6; k++) {
+                stm[(bodies.size() - 1) * 36 + k * 6 + k] = 1.0;
+            }
+            gradient.resize(bodies.size() * 9, 0.0);
+            stm_kick_old.resize(bodies.size() * 18, 0.0);
+        }
+
+        compute_all_accelerations();
+        bodies.back().ax_old = bodies.back().ax;
+        bodies.back().ay_old = bodies.back().ay;
+        bodies.back().az_old = bodies.back().az;
+    }
+
     // Velocity Verlet Integration (symplectic, better energy conservation)
+    // Regularized pairs use kick-drift-kick: half kick from external forces,
+    // Kepler drift of the pair, half kick with the new external forces.
     void step(double dt) {
+        maybe_autotune();
+
+        // Pairing changes alter which forces a(t) includes
+        if (update_regularized_pairs()) {
+            compute_all_accelerations();
+        }
+
         // Store old accelerations
         for (auto& body : bodies) {
             body.ax_old = body.ax;
@@ -552,27 +2900,69 @@ public:
             body.az_old = body.az;
         }
 
-        // Update positions: x(t+dt) = x(t) + v(t)*dt + 0.5*a(t)*dt²
-        for (auto& body : bodies) {
-            body.x += body.vx * dt + 0.5 * body.ax * dt * dt;
-            body.y += body.vy * dt + 0.5 * body.ay * dt * dt;
-            body.z += body.vz * dt + 0.5 * body.az * dt * dt;
+        if (variational_enabled) {
+            propagate_stm_positions(dt);
+        }
+
+        if (reproducible) update_positions<true>(dt);
+        else update_positions<false>(dt);
+        for (size_t i = 0; i < bodies.size(); i++) {
+            if (partner[i] > static_cast<int>(i)) {
+                drift_pair(static_cast<int>(i), partner[i], dt);
+            }
         }
 
         // Compute new accelerations
         compute_all_accelerations();
 
-        // Update velocities: v(t+dt) = v(t) + 0.5*(a(t) + a(t+dt))*dt
-        for (auto& body : bodies) {
-            body.vx += 0.5 * (body.ax_old + body.ax) * dt;
-            body.vy += 0.5 * (body.ay_old + body.ay) * dt;
-            body.vz += 0.5 * (body.az_old + body.az) * dt;
+        if (reproducible) update_velocities<true>(dt);
+        else update_velocities<false>(dt);
+
+        if (variational_enabled) {
+            propagate_stm_velocities(dt);
         }
 
         simulation_time += dt;
         step_count++;
     }
 
+    // Update positions: x(t+dt) = x(t) + v(t)*dt + 0.5*a(t)*dt²
+    // (regularized bodies only get their half kick here)
+    template <bool Unfused>
+    void update_positions(double dt) {
+        for (size_t i = 0; i < bodies.size(); i++) {
+            auto& body = bodies[i];
+            if (partner[i] >= 0) {
+                body.vx += product<Unfused>(0.5 * body.ax, dt);
+                body.vy += product<Unfused>(0.5 * body.ay, dt);
+                body.vz += product<Unfused>(0.5 * body.az, dt);
+                continue;
+            }
+            body.x += product<Unfused>(body.vx, dt) + product<Unfused>(0.5 * body.ax * dt, dt);
+            body.y += product<Unfused>(body.vy, dt) + product<Unfused>(0.5 * body.ay * dt, dt);
+            body.z += product<Unfused>(body.vz, dt) + product<Unfused>(0.5 * body.az * dt, dt);
+        }
+    }
+
+    // Update velocities: v(t+dt) = v(t) + 0.5*(a(t) + a(t+dt))*dt
+    template <bool Unfused>
+    void update_velocities(double dt) {
+        for (size_t i = 0; i < bodies.size(); i++) {
+            auto& body = bodies[i];
+            double old_weight = (partner[i] >= 0) ? 0.0 : 1.0;  // Already kicked
+            body.vx += product<Unfused>(0.5 * (product<Unfused>(old_weight, body.ax_old) + body.ax), dt);
+            body.vy += product<Unfused>(0.5 * (product<Unfused>(old_weight, body.ay_old) + body.ay), dt);
+            body.vz += product<Unfused>(0.5 * (product<Unfused>(old_weight, body.az_old) + body.az), dt);
+        }
+    }
+
+    // Recompute the total energy reported by get_total_energy and
+    // get_energy_error from the current state. simulate() does this at its
+    // end; step() does not, to keep the O(N^2) energy sum out of the loop.
+    void refresh_energy() {
+        total_energy = calculate_total_energy();
+    }
+
     // Run simulation for given duration
     void simulate(double duration, double dt) {
         int steps = static_cast<int>(duration / dt);
@@ -591,6 +2981,10 @@ public:
 
     // Calculate total mechanical energy (kinetic + potential)
     double calculate_total_energy() {
+        if (reproducible) {
+            return calculate_total_energy_reproducible();
+        }
+
         double kinetic = 0;
         double potential = 0;
 
@@ -614,6 +3008,42 @@ public:
         return kinetic + potential;
     }
 
+    // Energy with per-body rows (parallel on the threaded engine's pool)
+    // combined by pairwise_sum, so the result is independent of thread count
+    double calculate_total_energy_reproducible() {
+        const size_t n = bodies.size();
+        std::vector<double> kinetic(n), potential(n);
+        auto rows = [this, n, &kinetic, &potential](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                double v_sq = unfused_mul(bodies[i].vx, bodies[i].vx) +
+                              unfused_mul(bodies[i].vy, bodies[i].vy) +
+                              unfused_mul(bodies[i].vz, bodies[i].vz);
+                kinetic[i] = 0.5 * bodies[i].mass * v_sq;
+                double row = 0;
+                for (size_t j = i + 1; j < n; j++) {
+                    double dx = bodies[j].x - bodies[i].x;
+                    double dy = bodies[j].y - bodies[i].y;
+                    double dz = bodies[j].z - bodies[i].z;
+                    double r = std::sqrt(unfused_mul(dx, dx) + unfused_mul(dy, dy) + unfused_mul(dz, dz));
+                    row -= GRAV * bodies[i].mass * bodies[j].mass / r;
+                }
+                potential[i] = row;
+            }
+        };
+
+        if (force_engine == ENGINE_THREADED && engine_threads > 1) {
+            ensure_pool(pool, engine_threads);
+            const int threads = engine_threads;
+            // Rows shrink with i, so interleave them to balance the workers
+            pool->run([&rows, n, threads](int worker) {
+                for (size_t i = worker; i < n; i += threads) rows(i, i + 1);
+            });
+        } else {
+            rows(0, n);
+        }
+        return pairwise_sum(kinetic.data(), n) + pairwise_sum(potential.data(), n);
+    }
+
     // Calculate angular momentum (should be conserved)
     std::vector<double> calculate_angular_momentum() {
         double Lx = 0, Ly = 0, Lz = 0;
@@ -742,8 +3172,117 @@ public:
         const auto& body = bodies[body_index];
         return std::sqrt(body.vx*body.vx + body.vy*body.vy + body.vz*body.vz);
     }
+
+    // Batch counterparts of the per-body getters, one value per body
+    std::vector<double> get_speeds() { return get_metric_column(0); }
+    std::vector<double> get_distances_from_sun() { return get_metric_column(1); }
+    std::vector<double> get_distances_from_parent() { return get_metric_column(2); }
+    std::vector<double> get_orbital_periods() { return get_metric_column(3); }
+    std::vector<double> get_kinetic_energies() { return get_metric_column(4); }
+
+    // Get derived quantities for a list of bodies as flat array
+    // [speed0, dist_sun0, dist_parent0, period0, kinetic0, speed1, ...]
+    std::vector<double> get_body_metrics(const std::vector<int>& body_indices) {
+        std::vector<double> metrics(body_indices.size() * METRIC_COUNT);
+        compute_body_metrics(body_indices, metrics.data());
+        return metrics;
+    }
 };
 
+// Newtonian gravity only
+class SolarSystem : public BasicSolarSystem<> {
+#ifdef SOLAR_SYSTEM_PYTHON
+public:
+    // Zero-copy framebuffer view that keeps this system alive (see framebuffer_view_for)
+    pybind11::memoryview get_framebuffer_view() {
+        return framebuffer_view_for(pybind11::cast(this, pybind11::return_value_policy::reference));
+    }
+#endif
+};
+
+// Newtonian gravity with all perturbation terms enabled
+class PerturbedSolarSystem
+    : public BasicSolarSystem<J2Oblateness, PostNewtonian, SolarRadiationPressure> {
+#ifdef SOLAR_SYSTEM_PYTHON
+public:
+    pybind11::memoryview get_framebuffer_view() {
+        return framebuffer_view_for(pybind11::cast(this, pybind11::return_value_policy::reference));
+    }
+#endif
+};
+
+// ============================================================
+// ENSEMBLES
+// Independent systems run side by side, one member per worker at a time.
+// ============================================================
+
+// Run members 0..count-1 on up to workers threads, member k on thread
+// k % workers. Each member is constructed with set_num_threads(1), passed
+// to run(system, k) and destroyed on its thread, so all of its state is
+// allocated and first written there. With pinned, threads are pinned like
+// pool workers (plan_worker_cpus), spread over the NUMA nodes, and every
+// member's memory stays on its thread's node. run is called concurrently
+// for different members. The first exception thrown by run is rethrown
+// once all threads have finished.
+template <class System, class Run>
+void run_ensemble(int count, int workers, bool pinned, const Run& run) {
+    workers = std::max(1, std::min(workers, count));
+    std::vector<int> cpus;
+    if (pinned) cpus = plan_worker_cpus(detect_cpu_topology(), workers);
+    std::mutex mutex;
+    std::exception_ptr failure;
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; w++) {
+        threads.emplace_back([&, w] {
+            if (pinned) pin_current_thread(cpus[w]);
+            try {
+                for (int k = w; k < count; k += workers) {
+                    System system;
+                    system.set_num_threads(1);
+                    run(system, k);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    if (failure) std::rethrow_exception(failure);
+}
+
+// run_ensemble for Python: member k loads checkpoints[k] and simulates
+// duration with step dt (as a PerturbedSolarSystem when perturbed). Returns
+// each member's final positions (x, y, z per body) followed by its
+// velocities. Throws std::runtime_error naming the first checkpoint that
+// fails to load. The GIL is released while the members run.
+std::vector<std::vector<double>> run_checkpoint_ensemble(const std::vector<std::string>& checkpoints,
+                                                         double duration, double dt, int workers,
+                                                         bool pinned, bool perturbed) {
+    std::vector<std::vector<double>> states(checkpoints.size());
+    auto member = [&checkpoints, &states, duration, dt](auto& system, int k) {
+        if (!system.load_checkpoint(checkpoints[k])) {
+            throw std::runtime_error("run_checkpoint_ensemble: cannot load '" + checkpoints[k] + "'");
+        }
+        system.simulate(duration, dt);
+        std::vector<double> velocities = system.get_velocities();
+        states[k] = system.get_positions();
+        states[k].insert(states[k].end(), velocities.begin(), velocities.end());
+    };
+    {
+#ifdef SOLAR_SYSTEM_PYTHON
+        pybind11::gil_scoped_release release;
+#endif
+        const int count = static_cast<int>(checkpoints.size());
+        if (perturbed) {
+            run_ensemble<PerturbedSolarSystem>(count, workers, pinned, member);
+        } else {
+            run_ensemble<SolarSystem>(count, workers, pinned, member);
+        }
+    }
+    return states;
+}
+
 // Constants for Python access
 double get_AU() { return AU; }
 double get_DAY() { return DAY; }
@@ -0,0 +1,177 @@
+/**
+ * SOLAR SYSTEM SCALING BENCHMARK
+ *
+ * Measures how the threaded and multi-process force engines and ensembles
+ * scale with worker count, with and without NUMA-aware pinning (set_thread_affinity and
+ * run_ensemble). Run it on the target machine: the CPU topology is printed
+ * first, and rows past one node's CPU count show the cross-socket scaling.
+ *
+ * Build:  g++ -std=c++17 -O3 -pthread solar_system_bench.cpp -o solar_system_bench
+ * Usage:  solar_system_bench threads [n]        step time of the threaded engine
+ *                                               for n bodies (default 16384) on
+ *                                               1, 2, 4, ... threads
+ *         solar_system_bench processes [n]      step time of the multi-process
+ *                                               tree engine (opening angle 0.5)
+ *                                               for n bodies (default 65536) on
+ *                                               1, 2, 4, ... processes
+ *         solar_system_bench ensemble [members] members per second for an
+ *                                               ensemble (default 4 per CPU) of
+ *                                               real solar systems on 1, 2, 4, ...
+ *                                               workers
+ *
+ * Times are the median of several runs; speedups are against one unpinned
+ * worker.
+ */
+
+#include "solar_system.cpp"
+
+#include <cstdio>
+#include <random>
+
+namespace includecpp {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int hardware_threads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Thread counts 1, 2, 4, ... up to and including max
+std::vector<int> thread_counts(int max) {
+    std::vector<int> counts;
+    for (int t = 1; t < max; t *= 2) counts.push_back(t);
+    counts.push_back(max);
+    return counts;
+}
+
+// Checkpoint of n bodies of similar mass in a uniform sphere, which the
+// benchmark loads: adding bodies one by one recomputes all forces each time
+bool write_cluster(const std::string& path, size_t n) {
+    std::mt19937_64 random(n);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    std::ofstream out(path, std::ios::trunc);
+    out.precision(17);
+    out << "solar_system_checkpoint 1\n0 0 0 " << n << "\n";
+    for (size_t i = 0; i < n; i++) {
+        double x, y, z;
+        do {
+            x = unit(random); y = unit(random); z = unit(random);
+        } while (x*x + y*y + z*z > 1);
+        out << i << " -1 1e24 1e6 0 0 0 0 1 " << x * AU << " " << y * AU << " " << z * AU
+            << " 0 0 0 0 0 0 0 0 500 16777215 Body " << i << "\n";
+    }
+    out.close();
+    return !out.fail();
+}
+
+// Median seconds of several calls of step()
+template <class Step>
+double median_seconds(int samples, const Step& step) {
+    std::vector<double> times;
+    for (int s = 0; s < samples; s++) {
+        const Clock::time_point start = Clock::now();
+        step();
+        times.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    std::nth_element(times.begin(), times.begin() + samples / 2, times.end());
+    return times[samples / 2];
+}
+
+int report_threads(size_t n) {
+    const std::string path = "solar_system_bench.ckpt";
+    SolarSystem system;
+    const bool loaded = write_cluster(path, n) && system.load_checkpoint(path);
+    std::remove(path.c_str());
+    if (!loaded) {
+        std::fprintf(stderr, "cannot write %s in the current directory\n", path.c_str());
+        return 1;
+    }
+    system.set_force_engine("threaded");
+    double reference = 0;
+    for (int threads : thread_counts(hardware_threads())) {
+        std::printf("%6zu bodies %3d threads", n, threads);
+        for (bool pinned : {false, true}) {
+            system.set_num_threads(threads);
+            system.set_thread_affinity(pinned);
+            system.step(60);    // Creates the pool and places the arrays
+            const double seconds = median_seconds(5, [&] { system.step(60); });
+            if (reference == 0) reference = seconds;
+            std::printf("  %s %9.3f ms/step (%5.2fx)", pinned ? "pinned" : "free  ",
+                        seconds * 1e3, reference / seconds);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+int report_processes(size_t n) {
+    const std::string path = "solar_system_bench.ckpt";
+    SolarSystem system;
+    system.set_force_engine("processes");
+    const bool loaded = write_cluster(path, n) && system.load_checkpoint(path);
+    std::remove(path.c_str());
+    if (!loaded) {
+        std::fprintf(stderr, "cannot write %s in the current directory\n", path.c_str());
+        return 1;
+    }
+    double reference = 0;
+    for (int processes : thread_counts(hardware_threads())) {
+        system.set_num_processes(processes);
+        system.step(60);    // Forks the workers
+        const double seconds = median_seconds(5, [&] { system.step(60); });
+        if (reference == 0) reference = seconds;
+        std::printf("%6zu bodies %3d processes  %9.3f ms/step (%5.2fx)  engine %s\n", n, processes,
+                    seconds * 1e3, reference / seconds, system.get_force_engine().c_str());
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+int report_ensemble(int members) {
+    double reference = 0;
+    for (int workers : thread_counts(hardware_threads())) {
+        std::printf("%4d members %3d workers", members, workers);
+        for (bool pinned : {false, true}) {
+            const double seconds = median_seconds(3, [&] {
+                run_ensemble<SolarSystem>(members, workers, pinned, [](SolarSystem& system, int) {
+                    system.set_force_engine("direct");
+                    system.init_real_solar_system();
+                    for (int i = 0; i < 20000; i++) system.step(3600);
+                });
+            });
+            if (reference == 0) reference = seconds;
+            std::printf("  %s %8.2f members/s (%5.2fx)", pinned ? "pinned" : "free  ",
+                        members / seconds, reference / seconds);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+}  // namespace
+}  // namespace includecpp
+
+int main(int argc, char** argv) {
+    using namespace includecpp;
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "threads" || mode == "processes" || mode == "ensemble") {
+        std::printf("%s", SolarSystem().get_cpu_topology().c_str());
+    }
+    if (mode == "threads") {
+        const size_t n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16384;
+        return report_threads(std::max<size_t>(n, 2));
+    }
+    if (mode == "processes") {
+        const size_t n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 65536;
+        return report_processes(std::max<size_t>(n, 2));
+    }
+    if (mode == "ensemble") {
+        const int members = argc > 2 ? std::atoi(argv[2]) : 4 * hardware_threads();
+        return report_ensemble(std::max(members, 1));
+    }
+    std::fprintf(stderr, "usage: %s threads [n] | processes [n] | ensemble [members]\n", argv[0]);
+    return 2;
+}
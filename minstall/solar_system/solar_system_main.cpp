@@ -0,0 +1,259 @@
+/**
+ * SOLAR SYSTEM BATCH DRIVER
+ *
+ * Runs a SolarSystem simulation from a run description, without Python.
+ * A standalone tool: it defines main() and compiles solar_system.cpp into
+ * itself, so it is built on its own and is not one of the module's files.
+ *
+ * Build:  g++ -std=c++17 -O3 -pthread solar_system_main.cpp -o solar_system_run
+ * Usage:  solar_system_run run.toml
+ *
+ * Run description (TOML subset: key = value, # comments, [sections] ignored):
+ *
+ *   initial = "real_solar_system"   # or a checkpoint file to resume from
+ *   force_model = "newtonian"       # or "perturbed" (J2, 1PN, radiation pressure)
+ *   dt = 21600                      # step [s]
+ *   duration = 3.15576e8            # simulated time to add [s], also when resuming
+ *   engine = "auto"                 # direct, pairwise, tiled, threaded, processes, auto
+ *   autotune_cache = "tune.tsv"     # file caching engine = "auto" decisions
+ *                                   # (default: per-user cache, "" disables)
+ *   threads = 8
+ *   processes = 8                   # worker processes for engine = "processes"
+ *   opening_angle = 0.5             # tree opening angle for engine = "processes"
+ *   regularization_radius = 0       # [m], 0 disables KS regularization
+ *   variational = false
+ *   trajectory_file = "trajectory.csv"
+ *   trajectory_every = 10           # steps between trajectory samples
+ *   checkpoint_file = "run.ckpt"
+ *   checkpoint_every = 10000        # steps between checkpoints (0: only at the end)
+ *
+ * Unknown keys and invalid values are errors reported with their line number.
+ */
+
+#include "solar_system.cpp"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+
+namespace includecpp {
+
+struct RunConfig {
+    std::string initial = "real_solar_system";
+    std::string force_model = "newtonian";
+    std::string engine = "direct";
+    std::string autotune_cache = default_autotune_cache_path();
+    std::string trajectory_file;
+    std::string checkpoint_file;
+    double dt = 6 * 3600.0;
+    double duration = YEAR;
+    double regularization_radius = 0;
+    double opening_angle = 0.5;
+    int threads = 1;
+    int processes = 1;
+    int trajectory_every = 10;
+    int checkpoint_every = 0;
+    bool variational = false;
+};
+
+inline std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+inline bool is_one_of(const std::string& value, std::initializer_list<const char*> choices) {
+    for (const char* choice : choices) {
+        if (value == choice) return true;
+    }
+    return false;
+}
+
+// Parse the run description. On failure returns false and sets error.
+inline bool parse_run_config(const std::string& path, RunConfig& config, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    auto fail = [&](const std::string& message) {
+        error = path + ":" + std::to_string(line_number) + ": " + message;
+        return false;
+    };
+    while (std::getline(in, line)) {
+        line_number++;
+        // Strip comments outside of quoted strings
+        bool quoted = false;
+        for (size_t k = 0; k < line.size(); k++) {
+            if (line[k] == '"') quoted = !quoted;
+            if (line[k] == '#' && !quoted) {
+                line.resize(k);
+                break;
+            }
+        }
+        line = trim(line);
+        if (line.empty() || line[0] == '[') continue;
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) return fail("expected key = value");
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+
+        char* end = nullptr;
+        double number = std::strtod(value.c_str(), &end);
+        bool is_number = !value.empty() && end == value.c_str() + value.size() && std::isfinite(number);
+        bool is_count = is_number && number >= 0 && number <= INT_MAX && number == std::floor(number);
+        int* count = key == "threads" ? &config.threads
+                   : key == "processes" ? &config.processes
+                   : key == "trajectory_every" ? &config.trajectory_every
+                   : key == "checkpoint_every" ? &config.checkpoint_every
+                   : nullptr;
+        double* real = key == "dt" ? &config.dt
+                     : key == "duration" ? &config.duration
+                     : key == "regularization_radius" ? &config.regularization_radius
+                     : key == "opening_angle" ? &config.opening_angle
+                     : nullptr;
+
+        if (key == "initial") config.initial = value;
+        else if (key == "trajectory_file") config.trajectory_file = value;
+        else if (key == "checkpoint_file") config.checkpoint_file = value;
+        else if (key == "autotune_cache") config.autotune_cache = value;
+        else if (key == "force_model") {
+            if (!is_one_of(value, {"newtonian", "perturbed"})) {
+                return fail("unknown force_model '" + value + "'");
+            }
+            config.force_model = value;
+        }
+        else if (key == "engine") {
+            if (!is_one_of(value, {"direct", "pairwise", "tiled", "threaded", "processes", "auto"})) {
+                return fail("unknown engine '" + value + "'");
+            }
+            config.engine = value;
+        }
+        else if (key == "variational") {
+            if (value != "true" && value != "false") return fail("variational must be true or false");
+            config.variational = (value == "true");
+        }
+        else if (count) {
+            if (!is_count) return fail(key + " must be a non-negative integer");
+            *count = static_cast<int>(number);
+        }
+        else if (real) {
+            if (!is_number) return fail(key + " must be a number");
+            *real = number;
+        }
+        else {
+            return fail("unknown key '" + key + "'");
+        }
+    }
+
+    if (config.dt <= 0 || config.duration < 0 || config.opening_angle < 0) {
+        error = "dt must be positive, duration and opening_angle non-negative";
+        return false;
+    }
+    return true;
+}
+
+// Append one CSV row per body: time, name, position [m], velocity [m/s]
+template <class System>
+void write_trajectory_sample(std::FILE* out, System& system, const std::vector<std::string>& names) {
+    std::vector<double> pos = system.get_positions();
+    std::vector<double> vel = system.get_velocities();
+    double time = system.get_simulation_time();
+    for (size_t i = 0; i < names.size(); i++) {
+        std::fprintf(out, "%.17g,%s,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n", time, names[i].c_str(),
+                     pos[i*3], pos[i*3+1], pos[i*3+2], vel[i*3], vel[i*3+1], vel[i*3+2]);
+    }
+}
+
+template <class System>
+int run_simulation(const RunConfig& config) {
+    System system;
+    system.set_num_threads(config.threads);
+    system.set_num_processes(config.processes);
+    system.set_opening_angle(config.opening_angle);
+    system.set_force_engine(config.engine);
+    system.set_autotune_cache(config.autotune_cache);
+    system.set_regularization_radius(config.regularization_radius);
+    system.set_variational(config.variational);
+
+    if (config.initial == "real_solar_system") {
+        system.init_real_solar_system();
+    } else if (!system.load_checkpoint(config.initial)) {
+        std::fprintf(stderr, "error: cannot load checkpoint %s\n", config.initial.c_str());
+        return 1;
+    }
+
+    std::FILE* trajectory = nullptr;
+    if (!config.trajectory_file.empty()) {
+        trajectory = std::fopen(config.trajectory_file.c_str(), "w");
+        if (!trajectory) {
+            std::fprintf(stderr, "error: cannot write %s\n", config.trajectory_file.c_str());
+            return 1;
+        }
+        std::fprintf(trajectory, "time,body,x,y,z,vx,vy,vz\n");
+    }
+
+    std::vector<std::string> names = system.get_names();
+    long long steps = static_cast<long long>(config.duration / config.dt);
+    auto start = std::chrono::steady_clock::now();
+    int failed_checkpoints = 0;
+
+    for (long long i = 0; i < steps; i++) {
+        if (trajectory && config.trajectory_every > 0 && i % config.trajectory_every == 0) {
+            write_trajectory_sample(trajectory, system, names);
+        }
+        system.step(config.dt);
+        if (!config.checkpoint_file.empty() && config.checkpoint_every > 0
+            && (i + 1) % config.checkpoint_every == 0 && !system.save_checkpoint(config.checkpoint_file)) {
+            // Keep simulating; the previous checkpoint is still intact
+            std::fprintf(stderr, "warning: cannot write %s after step %lld\n", config.checkpoint_file.c_str(), i + 1);
+            failed_checkpoints++;
+        }
+    }
+    if (trajectory) {
+        write_trajectory_sample(trajectory, system, names);
+        std::fclose(trajectory);
+    }
+
+    system.refresh_energy();
+    if (!config.checkpoint_file.empty() && !system.save_checkpoint(config.checkpoint_file)) {
+        std::fprintf(stderr, "error: cannot write %s\n", config.checkpoint_file.c_str());
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("steps: %lld  simulated: %.3f years  wall: %.3f s  engine: %s  energy error: %.3e\n",
+                steps, system.get_simulation_time_years(), elapsed,
+                system.get_force_engine().c_str(), system.get_energy_error());
+    return failed_checkpoints ? 1 : 0;
+}
+
+}  // namespace includecpp
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s run.toml\n", argv[0]);
+        return 2;
+    }
+
+    includecpp::RunConfig config;
+    std::string error;
+    if (!includecpp::parse_run_config(argv[1], config, error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 2;
+    }
+
+    if (config.force_model == "perturbed") {
+        return includecpp::run_simulation<includecpp::PerturbedSolarSystem>(config);
+    }
+    return includecpp::run_simulation<includecpp::SolarSystem>(config);
+}
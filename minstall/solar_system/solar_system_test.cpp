@@ -0,0 +1,422 @@
+/**
+ * SOLAR SYSTEM BEHAVIOUR TESTS
+ *
+ * Checks SolarSystem behaviour against uninterrupted runs and exact
+ * identities.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread solar_system_test.cpp -o solar_system_test
+ * Usage:  solar_system_test   (exit status 0 when every check passes)
+ */
+
+#include "solar_system.cpp"
+
+#include <cstdio>
+#include <random>
+
+namespace includecpp {
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+bool file_exists(const std::string& path) {
+    return static_cast<bool>(std::ifstream(path));
+}
+
+// A loaded checkpoint continues bit-for-bit like the system that wrote it
+template <class System>
+void test_checkpoint_round_trip(const std::string& path) {
+    System original;
+    original.init_real_solar_system();
+    original.simulate(10 * DAY, 3600);
+    CHECK(original.save_checkpoint(path));
+    CHECK(!file_exists(path + ".tmp"));
+
+    System restored;
+    CHECK(restored.load_checkpoint(path));
+    CHECK(restored.get_names() == original.get_names());
+    CHECK(restored.get_positions() == original.get_positions());
+    CHECK(restored.get_velocities() == original.get_velocities());
+    CHECK(restored.get_simulation_time() == original.get_simulation_time());
+    CHECK(restored.get_step_count() == original.get_step_count());
+
+    for (int i = 0; i < 100; i++) {
+        original.step(3600);
+        restored.step(3600);
+    }
+    CHECK(restored.get_positions() == original.get_positions());
+    original.refresh_energy();
+    restored.refresh_energy();
+    CHECK(restored.get_energy_error() == original.get_energy_error());
+
+    // A failed save keeps the previous checkpoint
+    CHECK(!original.save_checkpoint(path + ".missing/checkpoint"));
+    CHECK(restored.load_checkpoint(path));
+    std::remove(path.c_str());
+
+    // Malformed files leave the system unchanged
+    {
+        std::ofstream(path) << "solar_system_checkpoint 1\n0 0 0 3\n";
+    }
+    std::vector<double> before = restored.get_positions();
+    CHECK(!restored.load_checkpoint(path));
+    CHECK(restored.get_positions() == before);
+    std::remove(path.c_str());
+}
+
+// KS pairs and state-transition matrices survive a checkpoint, so a resumed
+// regularized variational run continues bit-for-bit
+void test_checkpoint_regularized_variational(const std::string& path) {
+    SolarSystem original, restored;
+    for (SolarSystem* system : {&original, &restored}) {
+        system->set_regularization_radius(1e9);
+        system->set_variational(true);
+    }
+    original.init_real_solar_system();
+    original.simulate(5 * DAY, 3600);
+    CHECK(original.get_regularized_pair_count() > 0);
+    CHECK(original.save_checkpoint(path));
+    CHECK(restored.load_checkpoint(path));
+    CHECK(restored.get_regularized_pair_count() == original.get_regularized_pair_count());
+    for (int i = 0; i < 50; i++) {
+        original.step(3600);
+        restored.step(3600);
+    }
+    CHECK(restored.get_positions() == original.get_positions());
+    CHECK(restored.get_state_transition_matrix(3) == original.get_state_transition_matrix(3));
+    std::remove(path.c_str());
+
+    // A body count the file cannot hold is rejected without allocating
+    {
+        std::ofstream(path) << "solar_system_checkpoint 3\n0 0 0 18446744073709551615\n";
+    }
+    CHECK(!restored.load_checkpoint(path));
+    std::remove(path.c_str());
+}
+
+// Checkpoint of n resting bodies of 1e24 kg spread through a sphere of 1 AU
+bool write_cluster(const std::string& path, size_t n) {
+    std::mt19937_64 random(n);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    std::ofstream out(path, std::ios::trunc);
+    out.precision(17);
+    out << "solar_system_checkpoint 1\n0 0 0 " << n << "\n";
+    for (size_t i = 0; i < n; i++) {
+        double x, y, z;
+        do {
+            x = unit(random); y = unit(random); z = unit(random);
+        } while (x*x + y*y + z*z > 1);
+        out << i << " -1 1e24 1e6 0 0 0 0 1 " << x * AU << " " << y * AU << " " << z * AU
+            << " 0 0 0 0 0 0 0 0 500 16777215 Body " << i << "\n";
+    }
+    out.close();
+    return !out.fail();
+}
+
+// Accelerations at load time of the checkpointed cluster, from the first
+// step's drift of the resting bodies
+std::vector<double> cluster_accelerations(const std::string& path, const std::string& engine,
+                                          int processes, double theta) {
+    const double dt = 1e6;
+    SolarSystem system;
+    system.set_force_engine(engine);
+    system.set_num_processes(processes);
+    system.set_opening_angle(theta);
+    if (!system.load_checkpoint(path)) return {};
+    const std::vector<double> start = system.get_positions();
+    system.step(dt);
+    std::vector<double> a = system.get_positions();
+    for (size_t k = 0; k < a.size(); k++) a[k] = (a[k] - start[k]) * 2 / (dt * dt);
+    CHECK(system.get_force_engine() == engine);
+    return a;
+}
+
+// Largest deviation from reference relative to the largest reference component
+double max_relative_error(const std::vector<double>& a, const std::vector<double>& reference) {
+    double error = 0, scale = 0;
+    for (size_t k = 0; k < reference.size(); k++) {
+        error = std::max(error, std::abs(a[k] - reference[k]));
+        scale = std::max(scale, std::abs(reference[k]));
+    }
+    return error / scale;
+}
+
+// The process engine: with theta = 0 its LETs hold every body and the forces
+// are direct ones up to summation order; with theta = 0.5 they stay close.
+// It refuses to fork while another thread runs.
+void test_process_engine(const std::string& path) {
+    CHECK(write_cluster(path, 3000));
+    const std::vector<double> direct = cluster_accelerations(path, "direct", 1, 0);
+    CHECK(direct.size() == 3 * 3000);
+    CHECK(max_relative_error(cluster_accelerations(path, "processes", 3, 0), direct) < 1e-9);
+    CHECK(max_relative_error(cluster_accelerations(path, "processes", 1, 0), direct) < 1e-9);
+    const double approximate = max_relative_error(cluster_accelerations(path, "processes", 4, 0.5), direct);
+    CHECK(approximate > 0 && approximate < 1e-2);
+    std::remove(path.c_str());
+
+    // More workers than bodies leaves domains empty
+    SolarSystem reference, forked;
+    reference.init_real_solar_system();
+    forked.init_real_solar_system();
+    forked.set_num_processes(64);
+    forked.set_opening_angle(0);
+    forked.set_force_engine("processes");
+    for (int i = 0; i < 5; i++) {
+        reference.step(3600);
+        forked.step(3600);
+    }
+    CHECK(forked.get_force_engine() == "processes");
+    const std::vector<double> expected = reference.get_positions();
+    const std::vector<double> actual = forked.get_positions();
+    CHECK(max_relative_error(actual, expected) < 1e-12);
+
+    std::mutex mutex;
+    std::condition_variable released;
+    bool done = false;
+    std::thread other([&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&] { return done; });
+    });
+    forked.set_num_processes(3);    // A new group has to fork
+    forked.step(3600);
+    CHECK(forked.get_force_engine() == "direct");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    released.notify_one();
+    other.join();
+}
+
+// Drifting forward then back, or in two halves, returns to the same orbit
+void test_ks_drift() {
+    const double mu = GRAV * 2e30;
+    const double r0[3] = {1.5e11, 1e9, 3e8}, v0[3] = {-1000, 29000, 500};
+    double r[3] = {r0[0], r0[1], r0[2]}, v[3] = {v0[0], v0[1], v0[2]};
+    ks_kepler_drift(r, v, mu, 30 * DAY);
+    ks_kepler_drift(r, v, mu, -30 * DAY);
+    for (int k = 0; k < 3; k++) {
+        CHECK(std::abs(r[k] - r0[k]) < 1e-6 * 1.5e11);
+        CHECK(std::abs(v[k] - v0[k]) < 1e-6 * 29000);
+    }
+
+    double whole_r[3] = {r0[0], r0[1], r0[2]}, whole_v[3] = {v0[0], v0[1], v0[2]};
+    double half_r[3] = {r0[0], r0[1], r0[2]}, half_v[3] = {v0[0], v0[1], v0[2]};
+    ks_kepler_drift(whole_r, whole_v, mu, -20 * DAY);
+    ks_kepler_drift(half_r, half_v, mu, -10 * DAY);
+    ks_kepler_drift(half_r, half_v, mu, -10 * DAY);
+    for (int k = 0; k < 3; k++) {
+        CHECK(std::abs(whole_r[k] - half_r[k]) < 1e-6 * 1.5e11);
+    }
+
+    // Zero-length drift is a no-op
+    double still_r[3] = {r0[0], r0[1], r0[2]}, still_v[3] = {v0[0], v0[1], v0[2]};
+    ks_kepler_drift(still_r, still_v, mu, 0);
+    CHECK(still_r[0] == r0[0] && still_v[1] == v0[1]);
+}
+
+// get_force_engine names the engine that ran, after mode overrides
+void test_engine_reporting() {
+    SolarSystem system;
+    system.init_real_solar_system();
+    system.set_force_engine("tiled");
+    CHECK(system.get_force_engine() == "tiled");
+    system.set_reproducible(true);
+    CHECK(system.get_force_engine() == "direct");
+    system.step(3600);
+    CHECK(system.get_force_engine() == "direct");
+    system.set_reproducible(false);
+    system.step(3600);
+    CHECK(system.get_force_engine() == "tiled");
+
+    system.set_num_threads(2);
+    system.set_force_engine("threaded");
+    system.set_num_threads(4);
+    CHECK(system.get_num_threads() == 4);
+    system.step(3600);
+    CHECK(system.get_force_engine() == "threaded");
+
+    bool threw = false;
+    try {
+        system.set_force_engine("no-such-engine");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw && system.get_force_engine() == "threaded");
+    system.set_thread_affinity(true);
+    CHECK(system.get_cpu_topology().find("workers (4): caller ") != std::string::npos);
+    system.set_force_engine("processes");
+    CHECK(system.get_force_engine() == "processes");
+}
+
+// Autotuning leaves the forces of the current state as they were: with one
+// candidate engine, an "auto" run matches a "direct" run bit for bit
+void test_autotune_keeps_forces() {
+    SolarSystem direct, tuned;
+    for (SolarSystem* system : {&direct, &tuned}) {
+        system->set_num_threads(1);
+        system->set_reproducible(true);
+        system->init_real_solar_system();
+    }
+    direct.set_force_engine("direct");
+    tuned.set_autotune_cache("");
+    tuned.set_force_engine("auto");
+    for (int i = 0; i < 10; i++) {
+        direct.step(3600);
+        tuned.step(3600);
+    }
+    CHECK(tuned.get_force_engine() == "direct");
+    CHECK(tuned.get_positions() == direct.get_positions());
+    CHECK(tuned.get_velocities() == direct.get_velocities());
+}
+
+// Decisions land in the cache file through a temporary that is renamed
+// over it, and a later run reuses them
+void test_autotune_cache(const std::string& path) {
+    CHECK(!default_autotune_cache_path().empty() || !std::getenv("HOME"));
+    std::remove(path.c_str());
+    {
+        std::ofstream stale(path);
+        stale << "other cpu\t5\tplain\t1\t0\t1\n";
+    }
+    SolarSystem first;
+    first.set_num_threads(1);
+    first.set_autotune_cache(path);
+    first.init_real_solar_system();
+    first.set_force_engine("auto");
+    first.step(3600);
+    CHECK(!file_exists(path + ".tmp"));
+    std::ifstream in(path);
+    std::string line;
+    int lines = 0;
+    bool kept = false;
+    while (std::getline(in, line)) {
+        lines++;
+        if (line.compare(0, 9, "other cpu") == 0) kept = true;
+    }
+    CHECK(lines == 2 && kept);
+
+    SolarSystem second;
+    second.set_num_threads(1);
+    second.set_autotune_cache(path);
+    second.init_real_solar_system();
+    second.set_force_engine("auto");
+    second.step(3600);
+    CHECK(second.get_force_engine() == first.get_force_engine());
+    std::remove(path.c_str());
+}
+
+// Page-aligned row partitions: contiguous, covering, and the threaded
+// engine still matches the direct one bit for bit once they apply
+void test_threaded_partitions() {
+    for (int n : {7, 1024, 5000}) {
+        for (int threads : {1, 2, 3, 8}) {
+            int expected = 0;
+            for (int w = 0; w < threads; w++) {
+                int begin, end;
+                partition_rows(n, threads, w, begin, end);
+                CHECK(begin == expected && begin <= end);
+                if (w > 0 && n / threads >= PAGE_DOUBLES) CHECK(begin % PAGE_DOUBLES == 0);
+                expected = end;
+            }
+            CHECK(expected == n);
+        }
+    }
+
+    SolarSystem direct, threaded;
+    for (SolarSystem* system : {&direct, &threaded}) {
+        system->set_num_threads(2);
+        system->set_reproducible(true);
+        system->set_force_engine("direct");
+        system->init_real_solar_system();
+        for (int k = 0; k < 1100; k++) {
+            double r = AU * (2 + k * 1e-3), angle = k * 0.1;
+            system->add_test_particle(r * std::cos(angle), r * std::sin(angle), 0,
+                                      0, 0, 0, 0);
+        }
+    }
+    threaded.set_force_engine("threaded");
+    threaded.set_thread_affinity(true);
+    for (int i = 0; i < 3; i++) {
+        direct.step(3600);
+        threaded.step(3600);
+    }
+    CHECK(threaded.get_force_engine() == "threaded");
+    CHECK(threaded.get_positions() == direct.get_positions());
+}
+
+// Ensemble members run on pinned threads and match a serial run; a
+// member's exception reaches the caller
+void test_ensemble(const std::string& path) {
+    SolarSystem serial;
+    serial.init_real_solar_system();
+    for (int i = 0; i < 5; i++) serial.step(3600);
+
+    const int members = 5;
+    std::vector<std::vector<double>> positions(members);
+    run_ensemble<SolarSystem>(members, 2, true, [&](SolarSystem& system, int k) {
+        CHECK(system.get_num_threads() == 1);
+        system.init_real_solar_system();
+        for (int i = 0; i < 5; i++) system.step(3600);
+        positions[k] = system.get_positions();
+    });
+    for (const auto& member : positions) CHECK(member == serial.get_positions());
+
+    bool threw = false;
+    try {
+        run_ensemble<SolarSystem>(3, 3, false, [](SolarSystem&, int k) {
+            if (k == 1) throw std::runtime_error("member failed");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // The Python entry point: members from checkpoints, final state returned
+    CHECK(serial.save_checkpoint(path));
+    SolarSystem resumed;
+    CHECK(resumed.load_checkpoint(path));
+    resumed.simulate(2 * DAY, 3600);
+    std::vector<double> expected = resumed.get_positions();
+    const std::vector<double> velocities = resumed.get_velocities();
+    expected.insert(expected.end(), velocities.begin(), velocities.end());
+    const auto states = run_checkpoint_ensemble({path, path}, 2 * DAY, 3600, 2, true, false);
+    CHECK(states.size() == 2 && states[0] == expected && states[1] == expected);
+    threw = false;
+    try {
+        run_checkpoint_ensemble({path, path + ".missing"}, DAY, 3600, 2, false, false);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace includecpp
+
+int main() {
+    includecpp::test_checkpoint_round_trip<includecpp::SolarSystem>("solar_system_test.ckpt");
+    includecpp::test_checkpoint_round_trip<includecpp::PerturbedSolarSystem>("solar_system_test.ckpt");
+    includecpp::test_checkpoint_regularized_variational("solar_system_test.ckpt");
+    includecpp::test_process_engine("solar_system_test.ckpt");
+    includecpp::test_ks_drift();
+    includecpp::test_engine_reporting();
+    includecpp::test_autotune_keeps_forces();
+    includecpp::test_autotune_cache("solar_system_test.autotune");
+    includecpp::test_threaded_partitions();
+    includecpp::test_ensemble("solar_system_test.ckpt");
+    if (includecpp::failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", includecpp::failures);
+        return 1;
+    }
+    std::printf("solar_system: all checks passed\n");
+    return 0;
+}